@@ -0,0 +1,319 @@
+// bench_npu_monitor.cpp
+// 采集/导出热路径基准：NPUImpl::sample()、NPUCollector<T>::collect()、global_registry文本序列化，
+// 以及NPUSnapshotCollectable与“collect+Registry序列化”路径的对比；各采样分组单独的每周期开销；
+// 节点汇总按列SIMD归约与按NPUMetric逐设备标量计算的对比
+// 用法: bench_npu_monitor [每个用例的迭代次数，默认200]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dcmi_sim.h"
+#include "npu_impl.h"
+#include "npu_collector.h"
+#include "npu_sampler.h"
+#include "npu_snapshot_collectable.h"
+#include "npu_exposition_cache.h"
+
+/*全局内存分配计数（用于统计每轮分配次数）*/
+static std::atomic<unsigned long long> g_alloc_count{0};
+
+void* operator new(std::size_t size)
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr)throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/*模板化的假后端：与NPUImpl接口一致，数据在内存中生成，基准只测导出器本身*/
+class FakeNPU
+{
+public:
+    explicit FakeNPU(size_t devices) : tick_(0)
+    {
+        for (size_t i = 0; i < devices; i++)
+        {
+            NPULabel label;
+            label.card_id = (int)(i / DCMI_SIM_MAX_DEVICE_PER_CARD);
+            label.device_id = (int)(i % DCMI_SIM_MAX_DEVICE_PER_CARD);
+            label_list_.push_back(label);
+
+            NPUMetric m = NPUMetric();
+            m.aicore_freq = 1800;
+            m.aicpu_freq = 1900;
+            m.mem_freq = 2666;
+            m.voltage = 0.85;
+            m.hbm_total = 64ULL << 30;
+            metric_list_.push_back(m);
+        }
+    }
+
+    std::string name() const { return "fake_npu"; }
+    const std::vector<NPULabel>& labels() { return label_list_; }
+    void sample(std::vector<NPUMetric>& metrics)
+    {
+        //每轮改变数值，避免测到“值未变化”的特殊路径
+        tick_++;
+        for (size_t i = 0; i < metric_list_.size(); i++)
+        {
+            NPUMetric& m = metric_list_[i];
+            m.util_aicore = (uint32_t)((tick_ + i) % 101);
+            m.util_aicpu = (uint32_t)((tick_ * 3 + i) % 101);
+            m.util_mem = (uint32_t)((tick_ * 7 + i) % 101);
+            m.power = 80.0 + (double)((tick_ + i) % 220);
+            m.temperature = (int32_t)(40 + (tick_ + i) % 40);
+            m.hbm_used = (uint64_t)((tick_ + i) % 64) << 30;
+            m.hbm_temperature = (int32_t)(45 + (tick_ + i) % 30);
+            m.util_hbm_bw = (uint32_t)((tick_ * 5 + i) % 101);
+        }
+        metrics = metric_list_;
+    }
+
+private:
+    std::vector<NPULabel> label_list_;
+    std::vector<NPUMetric> metric_list_;
+    uint64_t tick_;
+};
+
+/*单个用例的统计结果*/
+struct BenchResult
+{
+    double p50_us;
+    double p99_us;
+    double ns_per_device;    //按中位数折算
+    double allocs_per_cycle;
+};
+
+/*运行fn若干轮并统计延迟分位数和分配次数*/
+template<typename F>
+BenchResult measure(size_t devices, int iterations, F fn)
+{
+    //预热：让惰性初始化（标签、指标注册等）不计入结果
+    for (int i = 0; i < 3; i++)fn();
+
+    std::vector<double> cost_ns;
+    cost_ns.reserve(iterations);
+    unsigned long long allocs = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        unsigned long long a0 = g_alloc_count.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        allocs += g_alloc_count.load(std::memory_order_relaxed) - a0;
+        cost_ns.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    std::sort(cost_ns.begin(), cost_ns.end());
+
+    BenchResult r;
+    r.p50_us = cost_ns[cost_ns.size() / 2] / 1000.0;
+    r.p99_us = cost_ns[std::min(cost_ns.size() - 1, cost_ns.size() * 99 / 100)] / 1000.0;
+    r.ns_per_device = cost_ns[cost_ns.size() / 2] / (double)devices;
+    r.allocs_per_cycle = (double)allocs / (double)iterations;
+    return r;
+}
+
+void print_result(const char* name, size_t devices, const BenchResult& r)
+{
+    std::printf("%-20s %8zu %12.1f %12.1f %12.1f %14.1f\n",
+        name, devices, r.p50_us, r.p99_us, r.ns_per_device, r.allocs_per_cycle);
+}
+
+/*配置模拟后端，使其恰好暴露devices个设备（卡数不超过MAX_CARD_NUM）*/
+void configure_sim(size_t devices)
+{
+    dcmi_sim_config config;
+    dcmi_sim_get_config(&config);
+    config.card_num = (int)std::min<size_t>(devices, MAX_CARD_NUM);
+    config.device_num_per_card = (int)(devices / config.card_num);
+    config.latency_us = 0;
+    config.jitter_us = 0;
+    config.error_rate = 0.0;
+    dcmi_sim_set_config(&config);
+}
+
+/*NPUImpl::sample()（模拟后端零延迟，测的是采集框架开销）*/
+void bench_impl(NPUSampleMode mode, const char* name, size_t devices, int iterations)
+{
+    NPUImpl impl(mode);
+    configure_sim(devices);
+    impl.labels();
+    std::vector<NPUMetric> metrics;
+    print_result(name, devices, measure(devices, iterations, [&] { impl.sample(metrics); }));
+}
+
+/*单个采样分组的每周期开销：其余分组设为长间隔，预热后每轮只有该组到期*/
+void bench_group(NPUMetricGroup group, const char* name, size_t devices, int iterations)
+{
+    NPUImpl impl(NPUSampleMode::SERIAL);
+    configure_sim(devices);
+    impl.labels();
+    for (int g = 0; g < NPU_GROUP_NUM; g++)
+    {
+        if (g != group)impl.set_group_interval((NPUMetricGroup)g, std::chrono::hours(1));
+    }
+    std::vector<NPUMetric> metrics;
+    print_result(name, devices, measure(devices, iterations, [&] { impl.sample(metrics); }));
+}
+
+/*节点汇总的标量基线：按NPUMetric逐设备跨步访问，语义与npu_node_aggregate()一致*/
+void scalar_node_aggregate(const NPUMetric* metrics, size_t count, NPUNodeAggregate& out)
+{
+    out = NPUNodeAggregate();
+    out.devices = count;
+    uint64_t util_sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const NPUMetric& m = metrics[i];
+        if (m.failed != 0)out.devices_failed++;
+        out.power_sum += m.power;
+        if (!(m.failed & NPU_METRIC_BIT(temperature)))
+        {
+            if (out.temperature_devices == 0 || m.temperature > out.temperature_max)out.temperature_max = m.temperature;
+            out.temperature_devices++;
+        }
+        if (!(m.failed & NPU_METRIC_BIT(util_aicore)))
+        {
+            if (out.util_aicore_devices == 0 || m.util_aicore < out.util_aicore_min)out.util_aicore_min = m.util_aicore;
+            util_sum += m.util_aicore;
+            out.util_aicore_devices++;
+        }
+    }
+    if (out.util_aicore_devices > 0)out.util_aicore_mean = (double)util_sum / out.util_aicore_devices;
+}
+
+/*节点汇总：每轮计算多次以超过计时精度，结果按单次计算折算*/
+void bench_node_aggregate(FakeNPU& fake, size_t devices, int iterations)
+{
+    const int repeat = 64;
+    std::vector<NPUMetric> metrics;
+    fake.sample(metrics);
+    //每16个设备有一个温度读取失败，覆盖排除失败设备的路径
+    for (size_t i = 0; i < metrics.size(); i += 16)metrics[i].failed = NPU_METRIC_BIT(temperature);
+    std::unique_ptr<NPUColumns> columns(new NPUColumns());
+    npu_columns_fill(*columns, metrics.data(), metrics.size());
+
+    volatile double sink = 0;
+    NPUNodeAggregate node;
+    BenchResult scalar = measure(devices, iterations, [&] {
+        for (int k = 0; k < repeat; k++)
+        {
+            scalar_node_aggregate(metrics.data(), metrics.size(), node);
+            sink = sink + node.util_aicore_mean + node.temperature_max;
+        }
+    });
+    BenchResult simd = measure(devices, iterations, [&] {
+        for (int k = 0; k < repeat; k++)
+        {
+            npu_node_aggregate(*columns, node);
+            sink = sink + node.util_aicore_mean + node.temperature_max;
+        }
+    });
+    BenchResult* results[] = {&scalar, &simd};
+    for (BenchResult* r : results)
+    {
+        r->p50_us /= repeat;
+        r->p99_us /= repeat;
+        r->ns_per_device /= repeat;
+    }
+    print_result("node_agg_scalar", devices, scalar);
+    print_result("node_agg_columns", devices, simd);
+    std::printf("%-20s %8zu %11.2fx\n", "node_agg_speedup", devices, scalar.p50_us / simd.p50_us);
+}
+
+int main(int argc, char* argv[])
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    if (iterations <= 0)iterations = 200;
+
+    const size_t max_devices = (size_t)MAX_CARD_NUM * DCMI_SIM_MAX_DEVICE_PER_CARD;
+    std::printf("%-20s %8s %12s %12s %12s %14s\n",
+        "case", "devices", "p50(us)", "p99(us)", "ns/device", "allocs/cycle");
+
+    //设备数从小到大，global_registry中较小规模的序列是较大规模的子集
+    for (size_t devices = 1; devices <= max_devices; devices *= 2)
+    {
+        bench_impl(NPUSampleMode::SERIAL, "impl_sample_serial", devices, iterations);
+        bench_impl(NPUSampleMode::PARALLEL, "impl_sample_parallel", devices, iterations);
+        bench_group(NPU_GROUP_UTIL_POWER, "group_util_power", devices, iterations);
+        bench_group(NPU_GROUP_FREQ_VOLTAGE, "group_freq_voltage", devices, iterations);
+        bench_group(NPU_GROUP_TEMPERATURE, "group_temperature", devices, iterations);
+        bench_group(NPU_GROUP_HEALTH, "group_health", devices, iterations);
+        bench_group(NPU_GROUP_HBM, "group_hbm", devices, iterations);
+
+        FakeNPU fake(devices);
+        bench_node_aggregate(fake, devices, iterations);
+        NPUCollector<FakeNPU> collector(fake);
+        print_result("collector_collect", devices,
+            measure(devices, iterations, [&] { collector.collect(); }));
+
+        prometheus::TextSerializer serializer;
+        std::string body;
+        print_result("registry_serialize", devices,
+            measure(devices, iterations, [&] {
+                std::ostringstream out;
+                serializer.Serialize(out, global_registry->Collect());
+                body = out.str();
+            }));
+
+        //一次抓取的完整开销：Registry路径（collect + 序列化）对比快照直出路径
+        BenchResult registry_scrape = measure(devices, iterations, [&] {
+            collector.collect();
+            std::ostringstream out;
+            serializer.Serialize(out, global_registry->Collect());
+            body = out.str();
+        });
+        print_result("registry_scrape", devices, registry_scrape);
+
+        NPUSampler<FakeNPU> sampler(fake, std::chrono::seconds(1));
+        sampler.sample_once();
+        NPUSnapshotCollectable<NPUSampler<FakeNPU>> collectable(sampler);
+        BenchResult snapshot_scrape = measure(devices, iterations, [&] {
+            std::ostringstream out;
+            serializer.Serialize(out, collectable.Collect());
+            body = out.str();
+        });
+        print_result("snapshot_scrape", devices, snapshot_scrape);
+        std::printf("%-20s %8zu %11.2fx\n", "snapshot_speedup", devices,
+            registry_scrape.p50_us / snapshot_scrape.p50_us);
+
+        //预渲染缓存：每周期渲染一次，抓取只取共享缓冲
+        auto shared_collectable = std::make_shared<NPUSnapshotCollectable<NPUSampler<FakeNPU>>>(sampler);
+        NPUExpositionCache cache;
+        cache.add_collectable(shared_collectable);
+        uint64_t cycle = 0;
+        print_result("cache_render", devices,
+            measure(devices, iterations, [&] { cache.render(++cycle); }));
+        size_t served = 0;
+        print_result("cached_scrape", devices,
+            measure(devices, iterations, [&] { served += cache.current()->body.size(); }));
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#ifndef DCMI_SIM_H
+#define DCMI_SIM_H
+
+/*
+ * DCMI模拟后端--在没有NPU的机器上替代真实的libdcmi
+ * 实现dcmi_interface_api.h中采集器使用的dcmi_*接口，并额外提供下面的配置接口。
+ * 默认配置可通过环境变量覆盖（在dcmi_init时读取）：
+ *   NPU_SIM_CARDS            卡数量（1~MAX_CARD_NUM，默认1）
+ *   NPU_SIM_DEVICES_PER_CARD 每卡设备数（1~DCMI_SIM_MAX_DEVICE_PER_CARD，默认1）
+ *   NPU_SIM_LATENCY_US       每次调用的固定延迟（微秒，默认0）
+ *   NPU_SIM_JITTER_US        每次调用额外的随机延迟上限（微秒，默认0）
+ *   NPU_SIM_ERROR_RATE       每次设备级调用随机失败的概率（0~1，默认0）
+ *   NPU_SIM_ERROR_CODE       随机失败时返回的错误码（默认DCMI_ERR_CODE_INNER_ERR）
+ *   NPU_SIM_SEED             随机数种子
+ * 每个设备模拟一个RoCE端口（port_id为0），以及8个周期性退出、以新pid重启的进程
+ */
+
+#include "dcmi_interface_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DCMI_SIM_MAX_DEVICE_PER_CARD 8 //模拟的每卡最大设备数
+#define DCMI_SIM_MAX_FAULT_NUM 64      //最多同时注入的定向故障数
+
+/*模拟后端的全局配置*/
+struct dcmi_sim_config {
+    int card_num;                //卡数量
+    int device_num_per_card;     //每卡设备数
+    unsigned int latency_us;     //每次调用的固定延迟
+    unsigned int jitter_us;      //每次调用额外的随机延迟上限
+    double error_rate;           //随机失败概率
+    int error_code;              //随机失败时的返回值
+    unsigned int seed;           //随机数种子
+};
+
+/*可单独注入故障的调用类型*/
+enum dcmi_sim_call {
+    DCMI_SIM_CALL_ANY = 0,
+    DCMI_SIM_CALL_CARD_LIST,
+    DCMI_SIM_CALL_ALL_DEVICE_COUNT,
+    DCMI_SIM_CALL_DEVICE_ID_IN_CARD,
+    DCMI_SIM_CALL_UTILIZATION_RATE,
+    DCMI_SIM_CALL_AICORE_INFO,
+    DCMI_SIM_CALL_AICPU_INFO,
+    DCMI_SIM_CALL_FREQUENCY,
+    DCMI_SIM_CALL_POWER_INFO,
+    DCMI_SIM_CALL_HEALTH,
+    DCMI_SIM_CALL_TEMPERATURE,
+    DCMI_SIM_CALL_VOLTAGE,
+    DCMI_SIM_CALL_LOGIC_ID,
+    DCMI_SIM_CALL_SUBSCRIBE_FAULT_EVENT,
+    DCMI_SIM_CALL_HBM_INFO,
+    DCMI_SIM_CALL_HCCS_BANDWIDTH,
+    DCMI_SIM_CALL_PCIE_BANDWIDTH,
+    DCMI_SIM_CALL_NETDEV_PKT_STATS,
+    DCMI_SIM_CALL_PFC_DURATION,
+    DCMI_SIM_CALL_RESOURCE_INFO,
+    DCMI_SIM_CALL_NUM
+};
+
+/*替换当前配置（应在采样开始前调用），返回DCMI_OK或DCMI_ERR_CODE_INVALID_PARAMETER
+  在两次采样之间修改card_num/device_num_per_card可模拟设备热插拔，被移除的设备返回DCMI_ERR_CODE_INVALID_DEVICE_ID*/
+DCMIDLLEXPORT int dcmi_sim_set_config(const struct dcmi_sim_config *config);
+/*读取当前配置*/
+DCMIDLLEXPORT void dcmi_sim_get_config(struct dcmi_sim_config *config);
+
+/*注入定向故障：匹配call/card_id/device_id（-1表示任意）的调用先额外延迟delay_us，再返回ret
+  ret为DCMI_OK时只注入延迟；可在采样过程中调用*/
+DCMIDLLEXPORT int dcmi_sim_add_fault(
+    enum dcmi_sim_call call, int card_id, int device_id, int ret, unsigned int delay_us);
+/*清除全部定向故障*/
+DCMIDLLEXPORT void dcmi_sim_clear_faults(void);
+
+/*模拟驱动上报一个故障事件：同步调用dcmi_subscribe_fault_event注册的回调（在调用线程上，与真实驱动的通知线程相当）
+  未订阅时返回DCMI_ERR_CODE_NOT_REDAY；逻辑ID为card_id * DCMI_SIM_MAX_DEVICE_PER_CARD + device_id*/
+DCMIDLLEXPORT int dcmi_sim_raise_fault_event(int card_id, int device_id, unsigned int event_id,
+    unsigned char severity, unsigned char assertion, const char *event_name);
+
+/*自dcmi_init以来的dcmi_*调用总次数*/
+DCMIDLLEXPORT unsigned long long dcmi_sim_get_call_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DCMI_SIM_H
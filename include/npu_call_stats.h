@@ -0,0 +1,95 @@
+#ifndef NPU_CALL_STATS_H
+#define NPU_CALL_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "npu_metrics.h"
+
+/*DCMI调用点：X(编号后缀, call标签值)*/
+#define NPU_DCMI_CALL_LIST(X) \
+    X(UTIL_AICORE, "utilization_rate_aicore") \
+    X(UTIL_AICPU, "utilization_rate_aicpu") \
+    X(UTIL_MEM, "utilization_rate_mem") \
+    X(AICORE_INFO, "aicore_info") \
+    X(AICPU_INFO, "aicpu_info") \
+    X(FREQ_MEM, "frequency_mem") \
+    X(POWER_INFO, "power_info") \
+    X(HEALTH, "health") \
+    X(TEMPERATURE, "temperature") \
+    X(VOLTAGE, "voltage") \
+    X(HBM_INFO, "hbm_info") \
+    X(UTIL_HBM_BW, "utilization_rate_hbm_bandwidth")
+
+/*调用点编号（NPU_CALL_<后缀>）*/
+enum NPUDcmiCall
+{
+#define NPU_DCMI_CALL_INDEX(id, name) NPU_CALL_##id,
+    NPU_DCMI_CALL_LIST(NPU_DCMI_CALL_INDEX)
+#undef NPU_DCMI_CALL_INDEX
+    NPU_CALL_NUM
+};
+
+/*调用点名称*/
+const char* npu_dcmi_call_name(int call);
+
+/*耗时直方图的桶数（不含+Inf）及各桶上界（秒）*/
+#define NPU_CALL_BUCKET_NUM 16
+extern const double NPU_CALL_BUCKET_BOUNDS[NPU_CALL_BUCKET_NUM];
+
+/*单个调用点的耗时直方图与错误计数（单写者，读者可并发读取）*/
+struct NPUCallHistogram
+{
+    std::atomic<uint64_t> buckets[NPU_CALL_BUCKET_NUM + 1]; //非累积计数，最后一个为+Inf
+    std::atomic<uint64_t> sum_ns;
+    std::atomic<uint64_t> errors;
+};
+
+/*单个设备的全部调用统计*/
+struct NPUDeviceCallStats
+{
+    std::atomic<int> card_id;
+    std::atomic<int> device_id;
+    NPUCallHistogram calls[NPU_CALL_NUM];
+};
+
+/*DCMI调用耗时统计--按(设备槽位, 调用点)记录，预分配NPU_MAX_DEVICE_NUM个槽位*/
+/*record()只做几次relaxed原子加，可在采样热路径上调用*/
+class NPUCallStats
+{
+public:
+    NPUCallStats();
+
+    /*为槽位绑定设备并清零其统计*/
+    void reset_device(size_t slot, int card, int device);
+    /*设置已使用的槽位数（其中card为-1的是空槽位）*/
+    void set_device_count(size_t count);
+    /*已使用的槽位数*/
+    size_t device_count() const;
+
+    /*记录一次调用：耗时ns，是否失败*/
+    void record(size_t slot, NPUDcmiCall call, uint64_t ns, bool error)
+    {
+        NPUCallHistogram& h = devices_[slot].calls[call];
+        int b = 0;
+        while (b < NPU_CALL_BUCKET_NUM && ns > bounds_ns_[b])b++;
+        h.buckets[b].fetch_add(1, std::memory_order_relaxed);
+        h.sum_ns.fetch_add(ns, std::memory_order_relaxed);
+        if (error)h.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*读取槽位统计*/
+    const NPUDeviceCallStats& device(size_t slot) const
+    {
+        return devices_[slot];
+    }
+
+private:
+    std::unique_ptr<NPUDeviceCallStats[]> devices_;
+    std::atomic<size_t> device_count_;
+    uint64_t bounds_ns_[NPU_CALL_BUCKET_NUM];
+};
+
+#endif // NPU_CALL_STATS_H
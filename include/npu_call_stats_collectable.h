@@ -0,0 +1,25 @@
+#ifndef NPU_CALL_STATS_COLLECTABLE_H
+#define NPU_CALL_STATS_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_call_stats.h"
+
+/*导出器自监控：按(设备, 调用点)导出DCMI调用耗时直方图与错误计数*/
+/*  npu_exporter_dcmi_call_seconds{card_id,device_id,call}       histogram*/
+/*  npu_exporter_dcmi_call_errors_total{card_id,device_id,call}  counter*/
+class NPUCallStatsCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUCallStatsCollectable(const NPUCallStats& stats);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUCallStats& stats_;
+};
+
+#endif // NPU_CALL_STATS_COLLECTABLE_H
@@ -6,6 +6,11 @@
 #include <prometheus/exposer.h>
 #include <prometheus/text_serializer.h>
 
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
 #include "npu_impl.h"
 
 //创建一个全局的registry
@@ -15,134 +20,138 @@ namespace {
 
 /*prometheus模板化的NPU收集器--调用底层采集接口impl采到的数据，上传给prometheus*/
 /*模板类全部在头文件中实现*/
+/*T需提供 labels() 与 sample(std::vector<NPUMetric>&)*/
+/*序列按代淘汰：每次collect()为一代，写入的序列记下当前代号；连续max_idle_cycles代未写入的序列
+  （设备被移除等）用Family::Remove删除，导出内容与序列化开销随实际设备集收缩。
+  短暂消失后又出现的设备在此期间沿用原序列，不反复Add/Remove*/
 template<typename T>
 class NPUCollector 
 {
 public:
-    /*构造函数：注册Prometheus指标*/
-    NPUCollector(T& impl) : impl_(impl)
+    /*构造函数：按指标描述表注册Prometheus指标族（Families）
+      max_idle_cycles为序列未被写入的最大代数，超过后删除（0表示设备消失的当代即删除）*/
+    NPUCollector(T& impl, uint64_t max_idle_cycles = 3)
+        : impl_(impl), generation_(0), max_idle_cycles_(max_idle_cycles)
     {
-        //创建指标族（Families）
         auto& registry = *global_registry;
-        //AICore利用率
-        aicore_util_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_aicore_utilization_percent")
-            .Help("NPU AI Core utilization percentage")
-            .Register(registry);
-            
-        //AICPU利用率
-        aicpu_util_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_aicpu_utilization_percent")
-            .Help("NPU AI CPU utilization percentage")
-            .Register(registry);
-            
-        //Mem利用率
-        mem_util_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_memory_utilization_percent")
-            .Help("NPU memory utilization percentage")
-            .Register(registry);
-
-        //AICore频率
-        aicore_freq_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_aicore_frequency_mhz")
-            .Help("NPU AI Core frequency in MHz")
-            .Register(registry);
-            
-        //AICPU频率
-        aicpu_freq_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_aicpu_frequency_mhz")
-            .Help("NPU AI CPU frequency in MHz")
-            .Register(registry);
-            
-        //Mem频率
-        mem_freq_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_mem_frequency_mhz")
-            .Help("NPU mem frequency in MHz")
-            .Register(registry);
-
-        //功耗
-        power_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_power_watts")
-            .Help("NPU power consumption in watts")
-            .Register(registry);
-
-        //健康状态
-        health_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_health") 
-            .Help("NPU device health status (0:OK,1:WARN,2:ERROR,3:CRITICAL,0xFFFFFFFF:NOT_EXIST)")
-            .Register(registry);
-            
-        //温度
-        temperature_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_temperature_celsius")
-            .Help("NPU temperature in Celsius")
-            .Register(registry);
-            
-        //电压
-        voltage_gauge_ = &prometheus::BuildGauge()
-            .Name("npu_voltage_volts")
-            .Help("NPU voltage in Volts")
-            .Register(registry);
+        for (int k = 0; k < NPU_METRIC_NUM; k++)
+        {
+            families_[k] = &prometheus::BuildGauge()
+                .Name(npu_metric_desc(k).name)
+                .Help(npu_metric_desc(k).help)
+                .Register(registry);
+        }
     }
     
     /*收集数据并更新Prometheus指标*/
     void collect()
     {
         // 获取标签（设备列表）和指标数据
-        auto label_list = impl_.labels();
-        auto metric_list = impl_.sample();
+        const auto& label_list = impl_.labels();
+        impl_.sample(metric_list_);
+        generation_++;
+
+        // 设备列表变化时重新解析各设备的序列
+        if (!same_labels(label_list))resolve_series(label_list);
         
-        // 更新每个设备的指标
+        // 更新每个设备的指标：直接写入预先解析的句柄，无分配、无查表
+        double values[NPU_METRIC_NUM];
         for (size_t i = 0; i < label_list.size(); i++)
         {
-            const auto& label = label_list[i];
-            const auto& metric = metric_list[i];
-            
-            // 构建标签
-            std::map<std::string, std::string> labels = {
-                {"card_id", std::to_string(label.card_id)},
-                {"device_id", std::to_string(label.device_id)}
-            };
-            
-            //更新各个指标 - 使用Add()获取或创建带有标签的指标
-            aicore_util_gauge_->Add(labels).Set(metric.util_aicore);
-            aicpu_util_gauge_->Add(labels).Set(metric.util_aicpu);
-            mem_util_gauge_->Add(labels).Set(metric.util_mem);
-
-            aicore_freq_gauge_->Add(labels).Set(metric.aicore_freq);
-            aicpu_freq_gauge_->Add(labels).Set(metric.aicpu_freq);
-            mem_freq_gauge_->Add(labels).Set(metric.mem_freq);
-
-            power_gauge_->Add(labels).Set(metric.power);
-
-            health_gauge_->Add(labels).Set(metric.health);
-            temperature_gauge_->Add(labels).Set(metric.temperature);
-            voltage_gauge_->Add(labels).Set(metric.voltage);
+            Series& series = *active_[i];
+            series.generation = generation_;
+            npu_metric_values(metric_list_[i], values);
+            for (int k = 0; k < NPU_METRIC_NUM; k++)series.gauges[k]->Set(values[k]);
         }
+
+        // 只有存在不在当前设备集中的序列时才需要检查淘汰
+        if (series_.size() > active_.size())evict_idle();
     }
     
     // 获取registry，用于exposer
     static std::shared_ptr<prometheus::Registry> GetRegistry() {
         return global_registry;
     }
+
+    /*当前保留的设备数（含尚未淘汰的已消失设备）*/
+    size_t series_count() const
+    {
+        return series_.size();
+    }
     
 private:
+    /*一个设备的全部序列*/
+    struct Series
+    {
+        prometheus::Gauge* gauges[NPU_METRIC_NUM]; //按NPUMetricIndex编号
+        uint64_t generation; //最近一次写入的代号
+    };
+
     T& impl_;  //硬件实现引用
     
-    //Prometheus指标 - 使用Family<prometheus::Gauge>类型
-    prometheus::Family<prometheus::Gauge>* aicore_util_gauge_;
-    prometheus::Family<prometheus::Gauge>* aicpu_util_gauge_;
-    prometheus::Family<prometheus::Gauge>* mem_util_gauge_;
+    //Prometheus指标族，按NPUMetricIndex编号
+    prometheus::Family<prometheus::Gauge>* families_[NPU_METRIC_NUM];
 
-    prometheus::Family<prometheus::Gauge>* aicore_freq_gauge_;
-    prometheus::Family<prometheus::Gauge>* aicpu_freq_gauge_;
-    prometheus::Family<prometheus::Gauge>* mem_freq_gauge_;
+    //已Add的全部序列：(card_id, device_id) -> 序列（std::map的节点地址稳定，可被active_引用）
+    std::map<std::pair<int, int>, Series> series_;
+    //已解析的设备列表及其序列：active_[i]对应resolved_labels_[i]
+    std::vector<NPULabel> resolved_labels_;
+    std::vector<Series*> active_;
+    //当前代号与淘汰阈值
+    uint64_t generation_;
+    uint64_t max_idle_cycles_;
+    //采样缓冲，跨周期复用
+    std::vector<NPUMetric> metric_list_;
 
-    prometheus::Family<prometheus::Gauge>* power_gauge_;
+    /*设备列表是否与已解析的一致*/
+    bool same_labels(const std::vector<NPULabel>& label_list) const
+    {
+        if (label_list.size() != resolved_labels_.size())return false;
+        for (size_t i = 0; i < label_list.size(); i++)
+        {
+            if (label_list[i].card_id != resolved_labels_[i].card_id ||
+                label_list[i].device_id != resolved_labels_[i].device_id)return false;
+        }
+        return true;
+    }
 
-    prometheus::Family<prometheus::Gauge>* health_gauge_;
-    prometheus::Family<prometheus::Gauge>* temperature_gauge_;
-    prometheus::Family<prometheus::Gauge>* voltage_gauge_;
+    /*设备列表变化时解析各设备的序列：已有序列（包括尚未淘汰的已消失设备）沿用，
+      新设备调用Family::Add（Add只在这里调用）；离开设备集的序列留给evict_idle()按代淘汰*/
+    void resolve_series(const std::vector<NPULabel>& label_list)
+    {
+        active_.resize(label_list.size());
+        for (size_t i = 0; i < label_list.size(); i++)
+        {
+            auto key = std::make_pair(label_list[i].card_id, label_list[i].device_id);
+            auto it = series_.find(key);
+            if (it == series_.end())
+            {
+                std::map<std::string, std::string> labels = {
+                    {"card_id", std::to_string(label_list[i].card_id)},
+                    {"device_id", std::to_string(label_list[i].device_id)}
+                };
+                it = series_.emplace(key, Series()).first;
+                for (int k = 0; k < NPU_METRIC_NUM; k++)it->second.gauges[k] = &families_[k]->Add(labels);
+            }
+            active_[i] = &it->second;
+        }
+        resolved_labels_ = label_list;
+    }
+
+    /*删除超过max_idle_cycles代未写入的序列（Remove只在这里调用）*/
+    void evict_idle()
+    {
+        for (auto it = series_.begin(); it != series_.end();)
+        {
+            if (generation_ - it->second.generation <= max_idle_cycles_)
+            {
+                ++it;
+                continue;
+            }
+            for (int k = 0; k < NPU_METRIC_NUM; k++)families_[k]->Remove(it->second.gauges[k]);
+            it = series_.erase(it);
+        }
+    }
 };
 
-#endif // NPU_COLLECTOR_H
\ No newline at end of file
+#endif // NPU_COLLECTOR_H
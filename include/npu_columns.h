@@ -0,0 +1,64 @@
+#ifndef NPU_COLUMNS_H
+#define NPU_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "npu_metrics.h"
+
+#define NPU_COLUMN_ALIGN 16 //每列按128位SIMD向量对齐（不超过malloc保证的对齐，堆上分配的缓冲同样满足）
+
+/*列式存储：NPU_METRIC_LIST中的每个字段一列，各列为全部设备该字段的连续数组（下标与labels一致）*/
+/*跨设备计算（节点汇总等）按列顺序读取，不再在NPUMetric之间跨步访问*/
+struct NPUColumns
+{
+    size_t count; //有效设备数
+#define NPU_COLUMN(field, name, help) alignas(NPU_COLUMN_ALIGN) decltype(NPUMetric::field) field[NPU_MAX_DEVICE_NUM];
+    NPU_METRIC_LIST(NPU_COLUMN)
+#undef NPU_COLUMN
+};
+
+/*把count个设备的读数转置写入列式存储*/
+inline void npu_columns_fill(NPUColumns& columns, const NPUMetric* metrics, size_t count)
+{
+    if (count > NPU_MAX_DEVICE_NUM)count = NPU_MAX_DEVICE_NUM;
+    columns.count = count;
+    for (size_t i = 0; i < count; i++)
+    {
+#define NPU_COLUMN_FILL(field, name, help) columns.field[i] = metrics[i].field;
+        NPU_METRIC_LIST(NPU_COLUMN_FILL)
+#undef NPU_COLUMN_FILL
+    }
+}
+
+/*复制列式存储的有效部分*/
+inline void npu_columns_copy(NPUColumns& dst, const NPUColumns& src)
+{
+    size_t count = src.count > NPU_MAX_DEVICE_NUM ? NPU_MAX_DEVICE_NUM : src.count;
+    dst.count = count;
+#define NPU_COLUMN_COPY(field, name, help) std::memcpy(dst.field, src.field, count * sizeof(src.field[0]));
+    NPU_METRIC_LIST(NPU_COLUMN_COPY)
+#undef NPU_COLUMN_COPY
+}
+
+/*节点级汇总（设备数为0时其余字段为0）*/
+struct NPUNodeAggregate
+{
+    size_t devices;
+    size_t devices_failed;      //有字段读取失败的设备数
+    double power_sum;           //总功耗（W）
+    size_t temperature_devices; //参与温度汇总的设备数
+    int32_t temperature_max;    //最高温度（C）
+    size_t util_aicore_devices; //参与利用率汇总的设备数
+    double util_aicore_mean;    //AICore平均利用率（%）
+    uint32_t util_aicore_min;   //AICore最低利用率（%）
+};
+
+/*按列计算节点汇总：各列以SIMD向量分块归约，尾部逐个处理*/
+/*（bench_npu_monitor的node_agg_*用例：数十个设备以上约为逐设备标量计算的2倍，十几个设备以下反而略慢）*/
+/*该项字段读取失败的设备（failed列中的NPU_METRIC_BIT）不参与该项汇总（无参与设备时该项为0），
+  其他字段失败不影响；过期设备按沿用的读数参与*/
+void npu_node_aggregate(const NPUColumns& columns, NPUNodeAggregate& out);
+
+#endif // NPU_COLUMNS_H
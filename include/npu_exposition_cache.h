@@ -0,0 +1,53 @@
+#ifndef NPU_EXPOSITION_CACHE_H
+#define NPU_EXPOSITION_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <prometheus/collectable.h>
+
+#include "npu_http_server.h"
+
+/*一次渲染好的/metrics正文（发布后不可变）*/
+struct NPUExposition
+{
+    uint64_t generation;  //渲染序号：每次render()递增，不同正文的序号一定不同
+    uint64_t cycle;       //渲染时数据所属的采样周期（同一周期内可能因故障事件多次渲染）
+    std::string body;     //Prometheus文本格式
+    std::string gzip_body; //body的gzip压缩结果（未启用压缩时为空）
+};
+
+/*预渲染的/metrics响应缓存--每个采样周期渲染一次，抓取时直接返回共享缓冲*/
+/*抓取方数量增加时，抓取延迟与CPU开销保持不变*/
+/*启用gzip时同一代数据只压缩一次，Accept-Encoding接受gzip（gzip或"*"且q>0，显式的gzip项优先）的抓取
+  直接返回压缩结果*/
+class NPUExpositionCache
+{
+public:
+    explicit NPUExpositionCache(bool gzip = true);
+
+    /*注册参与渲染的Collectable（如Registry或NPUSnapshotCollectable）*/
+    void add_collectable(const std::weak_ptr<prometheus::Collectable>& collectable);
+
+    /*收集并序列化全部Collectable并发布新结果（通常在采样周期结束后调用，可在多个线程上调用）
+      cycle为数据所属的采样周期，响应头X-NPU-Cycle；X-NPU-Generation为缓存自己的渲染序号*/
+    void render(uint64_t cycle);
+
+    /*最新结果，尚未渲染时返回nullptr（无锁拷贝引用计数，不做任何格式化）*/
+    std::shared_ptr<const NPUExposition> current() const;
+
+    /*在server上注册path（默认/metrics），返回缓存内容*/
+    void serve(NPUHttpServer& server, const std::string& path = "/metrics");
+
+private:
+    bool gzip_;
+    std::mutex render_mutex_;  //只串行化渲染过程，读者不受影响
+    std::vector<std::weak_ptr<prometheus::Collectable>> collectables_;
+    uint64_t renders_; //已发布的渲染次数（render_mutex_保护）
+    std::shared_ptr<const NPUExposition> current_; //通过std::atomic_load/atomic_store访问
+};
+
+#endif // NPU_EXPOSITION_CACHE_H
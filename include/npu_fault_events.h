@@ -0,0 +1,113 @@
+#ifndef NPU_FAULT_EVENTS_H
+#define NPU_FAULT_EVENTS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "npu_mpsc_queue.h"
+
+struct dcmi_event;
+
+#define NPU_FAULT_RECENT_NUM 64   //保留的最近事件数
+#define NPU_FAULT_NAME_LEN 64     //事件名保留的长度（含结尾0）
+
+/*一个故障事件（由驱动回调入队时填写，card_id/device_id由后台线程解析）*/
+struct NPUFaultEvent
+{
+    unsigned int logic_id;       //驱动上报的设备逻辑ID
+    int card_id;                 //解析失败时为-1
+    int device_id;
+    unsigned int event_id;
+    unsigned char severity;
+    unsigned char assertion;     //0恢复，1产生，2一次性通知
+    int serial;                  //驱动的事件序号
+    uint64_t raised_ms;          //驱动记录的产生时间（毫秒）
+    uint64_t received_ms;        //回调收到的时刻（Unix毫秒）
+    char name[NPU_FAULT_NAME_LEN];
+};
+
+/*按(设备, 级别)累计的事件数*/
+struct NPUFaultCount
+{
+    int card_id;
+    int device_id;
+    unsigned int severity;
+    uint64_t count;
+};
+
+/*当前处于产生状态（未恢复）的故障数*/
+struct NPUFaultActive
+{
+    int card_id;
+    int device_id;
+    uint64_t count;
+};
+
+/*某一时刻的全部事件统计*/
+struct NPUFaultSnapshot
+{
+    std::vector<NPUFaultCount> counts;
+    std::vector<NPUFaultActive> active;
+    std::vector<NPUFaultEvent> recent; //按到达顺序，最新的在最后
+    uint64_t received;
+    uint64_t dropped;
+};
+
+/*推送式故障事件--通过dcmi_subscribe_fault_event订阅，驱动回调只做一次无锁入队，
+  后台线程解析设备、更新计数与最近事件表，并通知监听者；检测延迟为毫秒级*/
+/*驱动回调不带用户数据，因此进程内只有一个实例*/
+class NPUFaultEvents
+{
+public:
+    /*进程内唯一的实例*/
+    static NPUFaultEvents& instance();
+
+    /*订阅所有设备的故障事件（重复调用只订阅一次），失败时返回false（驱动不支持等），此时应保留健康轮询*/
+    bool subscribe();
+    /*是否已订阅成功*/
+    bool subscribed() const;
+
+    /*设置事件监听者：在后台线程上调用（如触发重新渲染）；每批事件取空后最多调用一次，
+      两次调用至少间隔100毫秒，期间的事件合并，参数为其中最新的事件（完整统计见snapshot）*/
+    void set_listener(const std::function<void(const NPUFaultEvent&)>& listener);
+
+    /*读取当前统计（可被任意线程调用）*/
+    NPUFaultSnapshot snapshot() const;
+
+private:
+    NPUFaultEvents();
+    ~NPUFaultEvents();
+
+    /*驱动回调：只入队，不加锁、不分配内存*/
+    static void on_event(struct dcmi_event* event);
+
+    NPUMpscQueue<NPUFaultEvent> queue_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<bool> subscribed_;
+
+    mutable std::mutex mutex_; //保护以下统计与监听者
+    std::map<std::pair<std::pair<int, int>, unsigned int>, uint64_t> counts_; //((卡, 设备), 级别) -> 次数
+    std::map<std::pair<int, int>, std::set<unsigned int>> active_; //(卡, 设备) -> 未恢复的事件ID
+    NPUFaultEvent recent_[NPU_FAULT_RECENT_NUM];
+    uint64_t received_;
+    std::function<void(const NPUFaultEvent&)> listener_;
+
+    std::condition_variable cv_;
+    bool stopping_;
+    std::thread thread_;
+
+    /*后台线程主循环*/
+    void run();
+    /*记录一个事件（调用时持有mutex_）*/
+    void apply(const NPUFaultEvent& event);
+};
+
+#endif // NPU_FAULT_EVENTS_H
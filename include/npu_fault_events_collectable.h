@@ -0,0 +1,29 @@
+#ifndef NPU_FAULT_EVENTS_COLLECTABLE_H
+#define NPU_FAULT_EVENTS_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_fault_events.h"
+
+/*导出推送式故障事件*/
+/*  npu_fault_events_total{card_id,device_id,severity}                          counter*/
+/*  npu_fault_active{card_id,device_id}                                         gauge  未恢复的故障数*/
+/*  npu_fault_event_timestamp_seconds{card_id,device_id,event_id,event_name,
+                                      severity,assertion}                      gauge  最近NPU_FAULT_RECENT_NUM个事件中
+                                                                                     每种事件最新的到达时刻*/
+/*  npu_exporter_fault_events_dropped_total                                     counter 队列满丢弃的事件数*/
+class NPUFaultEventsCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUFaultEventsCollectable(const NPUFaultEvents& events);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUFaultEvents& events_;
+};
+
+#endif // NPU_FAULT_EVENTS_COLLECTABLE_H
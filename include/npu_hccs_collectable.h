@@ -0,0 +1,28 @@
+#ifndef NPU_HCCS_COLLECTABLE_H
+#define NPU_HCCS_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_hccs_profiler.h"
+
+/*导出最近一个HCCS测量窗口的链路带宽（MB/s），测量失败的设备不导出带宽*/
+/*  npu_hccs_tx_bandwidth_megabytes_per_second{card_id,device_id,pcs}  gauge*/
+/*  npu_hccs_rx_bandwidth_megabytes_per_second{card_id,device_id,pcs}  gauge*/
+/*  npu_hccs_total_tx_bandwidth_megabytes_per_second{card_id,device_id} gauge*/
+/*  npu_hccs_total_rx_bandwidth_megabytes_per_second{card_id,device_id} gauge*/
+/*  npu_hccs_window_timestamp_seconds{card_id,device_id}               gauge  成功窗口的结束时刻*/
+class NPUHccsCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUHccsCollectable(const NPUHccsProfiler& profiler);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUHccsProfiler& profiler_;
+};
+
+#endif // NPU_HCCS_COLLECTABLE_H
@@ -0,0 +1,95 @@
+#ifndef NPU_HCCS_PROFILER_H
+#define NPU_HCCS_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "npu_metrics.h"
+#include "npu_worker_pool.h"
+
+#define NPU_HCCS_PCS_NUM 16 //每设备的PCS数（与DCMI_HCCS_MAX_PCS_NUM一致）
+
+/*一个设备最近一个测量窗口的HCCS带宽（单位与驱动一致，MB/s）*/
+struct NPUHccsBandwidth
+{
+    int card_id;
+    int device_id;
+    bool valid;           //最近一个窗口是否测量成功（失败或超时时其余字段为上一次成功的结果）
+    int64_t timestamp_ms; //成功窗口的结束时刻（Unix毫秒，0表示尚无）
+    double total_tx;
+    double total_rx;
+    double tx[NPU_HCCS_PCS_NUM];
+    double rx[NPU_HCCS_PCS_NUM];
+    uint32_t pcs_mask;    //曾经报告过非零带宽的PCS（导出时只导出这些PCS，避免序列随流量出现和消失）
+};
+
+/*HCCS链路带宽测量--dcmi_get_hccs_link_bandwidth_info在profiling_time窗口内阻塞，不能放在采样周期中*/
+/*独立的流水线阶段：后台线程每隔interval启动一个窗口，由每设备一个的工作线程同时测量全部设备，
+  窗口结束后整体发布，核心采样的节拍不受影响*/
+/*工作线程卡在驱动调用中时（超过窗口长度加宽限），该设备本窗口记为失败，线程返回前不再分发*/
+class NPUHccsProfiler
+{
+public:
+    /*构造函数：window为测量窗口（profiling_time），interval为相邻两个窗口开始的间隔（不小于window）*/
+    explicit NPUHccsProfiler(std::chrono::milliseconds window = std::chrono::milliseconds(1000),
+                             std::chrono::milliseconds interval = std::chrono::seconds(10));
+    ~NPUHccsProfiler();
+
+    NPUHccsProfiler(const NPUHccsProfiler&) = delete;
+    NPUHccsProfiler& operator=(const NPUHccsProfiler&) = delete;
+
+    /*设置测量的设备（可在任意线程调用，下一个窗口生效）；保留的设备沿用其结果*/
+    void set_devices(const std::vector<NPULabel>& labels);
+
+    /*启动/停止后台线程（stop()等待当前窗口结束）*/
+    void start();
+    void stop();
+
+    /*在调用线程上测量一个窗口（阻塞约window），start()之前可用于同步测量*/
+    void profile_once();
+
+    /*最近发布的结果（按设备顺序覆盖out），返回已完成的窗口数（0表示尚无）*/
+    uint64_t snapshot(std::vector<NPUHccsBandwidth>& out) const;
+
+    /*测量窗口长度*/
+    std::chrono::milliseconds window() const;
+
+private:
+    std::chrono::milliseconds window_;
+    std::chrono::milliseconds interval_;
+
+    mutable std::mutex mutex_; //保护发布的结果与待切换的设备集
+    std::vector<NPUHccsBandwidth> published_;
+    uint64_t windows_;
+    std::vector<NPULabel> pending_labels_;
+    bool pending_;
+
+    /*测量工作区（仅在窗口之间由发起线程调整）*/
+    std::vector<NPUHccsBandwidth> work_;
+    std::unique_ptr<std::atomic<uint64_t>[]> done_; //各设备最近完成的窗口编号
+    std::unique_ptr<NPUWorkerPool> pool_;           //第i个工作线程测量第i个设备
+    std::function<void(size_t)> task_;
+    std::atomic<uint64_t> job_window_;              //当前分发的窗口编号
+    uint64_t window_seq_;
+
+    std::thread thread_;
+    std::mutex run_mutex_;
+    std::condition_variable cv_;
+    bool running_;
+
+    /*切换到pending_labels_（有工作线程仍卡在驱动调用中时推迟），返回设备数*/
+    size_t apply_devices();
+    /*工作线程任务：测量第i个设备*/
+    void measure(size_t index);
+    /*后台线程主循环*/
+    void run();
+};
+
+#endif // NPU_HCCS_PROFILER_H
@@ -0,0 +1,101 @@
+#ifndef NPU_HISTORY_H
+#define NPU_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "npu_metrics.h"
+
+#define NPU_HISTORY_BLOCK_BYTES 2048               //压缩块大小（含块头）
+#define NPU_HISTORY_DEFAULT_BYTES (128 * 1024)     //默认每设备内存预算
+
+/*一个压缩块：块内第一个样本的时间戳记在块头，其后为位流*/
+struct NPUHistoryBlock
+{
+    int64_t first_ms;  //块内首个样本时间戳（Unix毫秒）
+    int64_t min_ms;    //块内样本时间戳的最小/最大值（时钟回拨时首尾样本不一定是极值）
+    int64_t max_ms;
+    uint64_t seq;      //块序号（每设备从1递增），读取按序号遍历，不依赖时间戳单调
+    uint32_t count;    //样本数
+    uint32_t bits;     //已写入的位数
+    uint64_t words[(NPU_HISTORY_BLOCK_BYTES - 40) / 8];
+};
+
+/*每设备的内存压缩历史--定长环形块存储，写满后覆盖最旧的块*/
+/*逐字段编码（Gorilla）：时间戳为二阶差分，double字段为与上一值的XOR，整型字段为差值（zigzag），
+  均按值域分档变长存储；NPU_METRIC_LIST中的字段自动纳入*/
+/*内存预算：每设备bytes_per_device（默认128KB）。2秒周期、读数正常波动时每样本约100~150位，
+  即约25~35KB/设备·小时，默认预算可保存约4小时；值不变的字段每样本只占1位*/
+/*append()在采样线程上调用：每设备O(1)，设备集不变时不分配内存；读取可在任意线程并发进行*/
+class NPUHistory
+{
+public:
+    explicit NPUHistory(size_t bytes_per_device = NPU_HISTORY_DEFAULT_BYTES);
+
+    NPUHistory(const NPUHistory&) = delete;
+    NPUHistory& operator=(const NPUHistory&) = delete;
+
+    /*追加一个周期的读数（labels与metrics一一对应）；新设备首次出现时分配其存储，
+      已移除设备的历史保留到进程退出，仍可读取*/
+    void append(int64_t timestamp_ms, const std::vector<NPULabel>& labels, const std::vector<NPUMetric>& metrics);
+
+    /*按写入顺序读取设备在[from_ms, to_ms]内的样本，返回样本数（时钟未回拨时即时间顺序；
+      回拨后范围内的样本同样全部返回）
+      逐块解码，visit在读取线程上调用，不持有任何锁；visit返回false时停止读取*/
+    size_t read(int card_id, int device_id, int64_t from_ms, int64_t to_ms,
+        const std::function<bool(int64_t, const NPUMetric&)>& visit) const;
+
+    /*有历史的设备*/
+    std::vector<NPULabel> devices() const;
+
+    /*已分配的存储（字节）*/
+    size_t memory_bytes() const;
+    /*每设备块数*/
+    size_t block_num() const;
+
+private:
+    /*编码状态（每块重新开始，解码时按相同规则重建）*/
+    struct Codec
+    {
+        int64_t prev_ms;
+        int64_t prev_delta;
+        uint64_t prev[NPU_METRIC_NUM];     //上一值：double为位模式，整型为符号扩展后的值
+        uint8_t leading[NPU_METRIC_NUM];   //XOR的前导零位数（0xFF表示尚无）
+        uint8_t trailing[NPU_METRIC_NUM];
+        void reset(int64_t first_ms);
+    };
+
+    struct Device
+    {
+        mutable std::mutex mutex;
+        NPULabel label;
+        std::unique_ptr<NPUHistoryBlock[]> blocks;
+        size_t head;  //正在写入的块
+        size_t used;  //已使用的块数
+        uint64_t next_seq; //下一个新块的序号
+        Codec codec;
+    };
+
+    size_t block_num_;
+
+    mutable std::mutex map_mutex_; //保护设备表
+    std::map<std::pair<int, int>, std::unique_ptr<Device>> devices_;
+
+    /*采样线程缓存：labels不变时直接按下标找到设备（仅append()访问）*/
+    std::vector<NPULabel> cached_labels_;
+    std::vector<Device*> cached_devices_;
+
+    /*向设备追加一个样本（调用时持有该设备的mutex）*/
+    void append_sample(Device& device, int64_t timestamp_ms, const NPUMetric& metric);
+    /*解码一个块，返回在范围内的样本数；visit返回false时置stopped*/
+    static size_t decode_block(const NPUHistoryBlock& block, int64_t from_ms, int64_t to_ms,
+        const std::function<bool(int64_t, const NPUMetric&)>& visit, bool& stopped);
+};
+
+#endif // NPU_HISTORY_H
@@ -0,0 +1,34 @@
+#ifndef NPU_HISTORY_ENDPOINT_H
+#define NPU_HISTORY_ENDPOINT_H
+
+#include <string>
+
+#include "npu_history.h"
+#include "npu_http_server.h"
+
+/*本地历史的范围查询端点*/
+/*  GET /history?card=&device=&metric=&from=&to=&step=&agg=
+      card, device  设备（必填）
+      metric        Prometheus指标名（如npu_power_watts）或NPUMetric字段名（如power）（必填）
+      from, to      Unix秒（可带小数），默认最近一小时
+      step          降采样步长（秒），0（默认）返回原始样本
+      agg           每个步长内的聚合方式：avg（默认）、min、max、last*/
+/*返回JSON：{"card_id":..,"device_id":..,"metric":"..","step":..,"agg":"..","values":[[秒,值],...]}
+  值为NaN或无穷大（含桶内聚合结果）时写为null
+  逐块解码、边降采样边以chunked编码发送，不在内存中展开整个时间窗*/
+class NPUHistoryEndpoint
+{
+public:
+    explicit NPUHistoryEndpoint(const NPUHistory& history);
+
+    /*在server上注册path（默认/history）*/
+    void serve(NPUHttpServer& server, const std::string& path = "/history");
+
+private:
+    const NPUHistory& history_;
+
+    /*处理一次查询*/
+    void handle(const NPUHttpRequest& req, NPUHttpResponse& resp) const;
+};
+
+#endif // NPU_HISTORY_ENDPOINT_H
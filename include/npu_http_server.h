@@ -0,0 +1,95 @@
+#ifndef NPU_HTTP_SERVER_H
+#define NPU_HTTP_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*HTTP请求（只解析导出器需要的部分）*/
+struct NPUHttpRequest
+{
+    std::string method;
+    std::string path;   //不含查询串
+    std::string query;  //'?'之后的部分
+    std::map<std::string, std::string> headers; //键为小写
+
+    /*取请求头（键为小写），不存在时返回空串*/
+    std::string header(const std::string& name) const;
+    /*取查询参数，不存在时返回def*/
+    std::string param(const std::string& name, const std::string& def = "") const;
+};
+
+/*HTTP响应
+  正文三选一：body；data/size指向的外部缓冲（由hold保持存活，用于零拷贝返回缓存内容）；
+  或stream：响应头发出后在处理线程上调用，以chunked编码边生成边发送（长度事先未知的大响应）*/
+struct NPUHttpResponse
+{
+    /*流式写入：发送一个分块，连接已断开时返回false，此时应停止生成*/
+    typedef std::function<bool(const char*, size_t)> Writer;
+
+    int status = 200;
+    std::string content_type = "text/plain; charset=utf-8";
+    std::string content_encoding;
+    std::vector<std::pair<std::string, std::string>> headers; //其他响应头
+    std::string body;
+    const char* data = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const void> hold;
+    std::function<void(const Writer&)> stream;
+};
+
+/*极简HTTP/1.1服务器--固定数量的线程阻塞accept，每个连接处理一个请求后关闭*/
+/*用于返回预渲染的/metrics等导出器自有端点，prometheus::Exposer无法直接返回预渲染内容*/
+/*每个连接从accept起有总时限，到期即关闭：缓慢或只涓流收发的客户端不能长期占住处理线程；
+  耗时长的流式端点（如/history）应放在单独的服务器上，不与/metrics共用处理线程*/
+class NPUHttpServer
+{
+public:
+    typedef std::function<void(const NPUHttpRequest&, NPUHttpResponse&)> Handler;
+
+    /*bind_address形如"0.0.0.0:8080"，threads为处理线程数，connection_timeout为每个连接从accept起的总时限*/
+    explicit NPUHttpServer(const std::string& bind_address, size_t threads = 2,
+                           std::chrono::milliseconds connection_timeout = std::chrono::seconds(10));
+    ~NPUHttpServer();
+
+    NPUHttpServer(const NPUHttpServer&) = delete;
+    NPUHttpServer& operator=(const NPUHttpServer&) = delete;
+
+    /*注册路径处理函数（应在start()之前调用）*/
+    void handle(const std::string& path, Handler handler);
+
+    /*绑定端口并启动处理线程，失败时抛出std::runtime_error*/
+    void start();
+    /*停止服务并回收线程*/
+    void stop();
+
+    /*实际监听的端口（bind端口为0时由系统分配）*/
+    int port() const;
+
+private:
+    std::string bind_address_;
+    size_t thread_num_;
+    std::chrono::milliseconds connection_timeout_;
+    std::map<std::string, Handler> handlers_;
+
+    int listen_fd_;
+    int port_;
+    std::atomic<bool> running_;
+    std::vector<std::thread> threads_;
+
+    /*处理线程主循环*/
+    void accept_loop();
+    /*处理一个连接，全部读写在deadline之前完成，否则放弃*/
+    void serve(int fd, std::chrono::steady_clock::time_point deadline);
+    /*以chunked编码发送流式响应*/
+    void send_stream(int fd, const NPUHttpRequest& req, NPUHttpResponse& resp,
+                     std::chrono::steady_clock::time_point deadline);
+};
+
+#endif // NPU_HTTP_SERVER_H
@@ -1,34 +1,126 @@
 #ifndef NPU_IMPL_H
 #define NPU_IMPL_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
+#include "npu_call_stats.h"
 #include "npu_metrics.h"
+#include "npu_worker_pool.h"
+
+/*采样模式（构造时确定）*/
+enum class NPUSampleMode
+{
+    SERIAL,   //在调用线程上逐个设备采集（不受周期截止时间约束）
+    PARALLEL  //按卡分发到固定的工作线程池并发采集
+};
+
+/*采样分组：各组可设置独立的采样间隔，未到期的组沿用上次读数*/
+enum NPUMetricGroup
+{
+    NPU_GROUP_UTIL_POWER,   //利用率、功耗
+    NPU_GROUP_FREQ_VOLTAGE, //频率、电压
+    NPU_GROUP_TEMPERATURE,  //温度
+    NPU_GROUP_HEALTH,       //健康状态
+    NPU_GROUP_HBM,          //HBM容量、温度、带宽利用率
+    NPU_GROUP_NUM
+};
+#define NPU_GROUP_BIT(group) (1u << (group))
 
 /*底层信息采集*/
 class NPUImpl
 {
 public:
-    /*构造函数：初始化DCMI*/
-    NPUImpl();
+    /*构造函数：初始化DCMI
+      mode为PARALLEL时，workers指定工作线程数，0表示每张卡一个工作线程*/
+    explicit NPUImpl(NPUSampleMode mode = NPUSampleMode::SERIAL, int workers = 0);
     
     /*返回收集器名称*/
     std::string name() const;
     
-    /*返回所有设备的标签*/
-    std::vector<NPULabel> labels();
+    /*返回所有设备的标签
+      开启重新枚举后，设备集可能在两次调用之间变化（热插拔、卡复位），调用者应按返回值重新对应*/
+    const std::vector<NPULabel>& labels();
     /*采集所有设备的指标数据*/
     std::vector<NPUMetric> sample();
+    /*采集所有设备的指标数据到metrics（大小不变时不分配内存）*/
+    void sample(std::vector<NPUMetric>& metrics);
+
+    /*设置分组的采样间隔：0（默认）表示每次sample()都采集，
+      否则距上次采集不足interval时该组沿用上次读数*/
+    void set_group_interval(NPUMetricGroup group, std::chrono::milliseconds interval);
+
+    /*设置每个采样周期的截止时间：0（默认）表示不限，只在PARALLEL模式下生效
+      到期仍未返回的设备标记为stale并沿用上次成功的读数，本周期不再等待；
+      其工作线程在卡住的调用返回前不再被分发，其他卡照常采集。
+      SERIAL模式只有调用线程，卡住的驱动调用无法被跳过，周期耗时不设上限*/
+    void set_cycle_deadline(std::chrono::milliseconds deadline);
+
+    /*设置重新枚举设备的间隔：0（默认）表示只在首次labels()时枚举
+      到期时先用dcmi_get_all_device_count快速检查，数量变化或有设备报告不存在时再完整枚举，
+      与当前设备集比较后增量增加或移除设备；由labels()在调用线程上执行*/
+    void set_rediscover_interval(std::chrono::milliseconds interval);
+    /*立即重新枚举（force为false时先做数量检查），设备集变化时返回true
+      有工作线程仍卡在驱动调用中时推迟，返回false*/
+    bool rediscover(bool force = false);
+
+    /*各设备DCMI调用的耗时与错误统计（可被其他线程并发读取）*/
+    const NPUCallStats& dcmi_call_stats() const;
     
 private:
     /*唯一的标签*/
     std::vector<NPULabel> label_list;
     bool is_label_initialized;
 
-    /*采集单个设备的指标*/
-    void collect_single_device(int card, int device, NPUMetric& metric);
-    /*错误信息*/
-    void raise_error(const std::string&msg, int ret,int card,int dev,bool fatal);
+    /*并行采样*/
+    NPUSampleMode mode;
+    int worker_num; //用户指定的工作线程数（0：每卡一个）
+    std::unique_ptr<NPUWorkerPool> pool;
+    std::vector<std::vector<size_t>> worker_devices; //每个工作线程负责的设备（label_list下标）
+    std::function<void(size_t)> worker_task; //分发给工作线程的任务（超时的线程可能在sample()返回后仍在执行）
+
+    /*周期截止*/
+    std::chrono::steady_clock::duration cycle_deadline;
+    uint64_t cycle_seq; //采样周期编号
+    std::atomic<uint64_t> job_cycle; //当前分发的周期编号
+    std::atomic<unsigned int> job_due; //当前分发的到期分组
+    std::unique_ptr<std::atomic<uint64_t>[]> device_done; //各设备最近完成的周期编号
+    std::vector<NPUMetric> good_metrics; //各设备最近一次按时完成的读数（对外输出）
+
+    /*分组调度*/
+    std::chrono::steady_clock::duration group_interval[NPU_GROUP_NUM];
+    std::chrono::steady_clock::time_point group_next[NPU_GROUP_NUM]; //各组下次到期时刻
+    std::vector<NPUMetric> device_metrics; //各设备的采集工作区（未到期分组的值由此保留，采集中归工作线程所有）
+
+    /*重新枚举*/
+    std::chrono::steady_clock::duration rediscover_interval;
+    std::chrono::steady_clock::time_point rediscover_next; //下次重新枚举的时刻
+    std::atomic<bool> rediscover_hint; //有设备报告不存在，下次labels()时完整枚举
+    int enumerated_count; //上次完整枚举时dcmi_get_all_device_count的原始返回值（-1：未知）
+
+    /*DCMI调用统计：设备在整个存续期间占用同一槽位，移除后槽位回收*/
+    NPUCallStats call_stats;
+    std::vector<size_t> stats_slot; //各设备（label_list下标）的统计槽位
+    std::vector<size_t> free_stats_slots; //已回收的槽位
+    size_t stats_slot_count; //曾使用过的槽位数
+
+    /*枚举当前所有卡和设备，dcmi_get_card_list失败时返回false（单卡失败只跳过该卡，complete置false）*/
+    bool enumerate_devices(std::vector<NPULabel>& found, int& card_count, bool& complete);
+    /*切换到设备集found，log_changes为true时记录增加与移除的设备*/
+    void apply_labels(const std::vector<NPULabel>& found, int card_count, bool log_changes);
+    /*按卡把设备划分给工作线程，并创建线程池*/
+    void init_workers(int card_count);
+    /*工作线程任务：采集worker负责的设备并登记完成周期*/
+    void worker_job(size_t worker);
+    /*计算本周期到期的分组（NPU_GROUP_BIT掩码），并推进各组下次到期时刻*/
+    unsigned int due_groups();
+    /*采集第index个设备中due指定的分组*/
+    void collect_single_device(size_t index, unsigned int due);
+    /*错误信息（msg须为字符串字面量）*/
+    void raise_error(const char* msg, int ret,int card,int dev,bool fatal);
 };
 
-#endif // NPU_IMPL_H
\ No newline at end of file
+#endif // NPU_IMPL_H
@@ -0,0 +1,84 @@
+#ifndef NPU_JOURNAL_H
+#define NPU_JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "npu_metrics.h"
+
+#define NPU_JOURNAL_DEFAULT_BYTES (64ULL * 1024 * 1024) //默认文件大小（512设备2秒周期约可保存50分钟）
+
+/*一条记录：一个设备在一个周期的读数，crc覆盖之前的全部字段，写到一半崩溃的记录在重放时被丢弃*/
+struct NPUJournalRecord
+{
+    uint64_t seq;          //全局递增序号（决定重放顺序与写入位置）
+    int64_t timestamp_ms;  //周期时间戳（Unix毫秒），同一周期的记录相同
+    NPULabel label;
+    NPUMetric metric;
+    uint32_t crc;
+};
+
+/*崩溃安全的采样日志--预分配的文件以mmap映射为定长记录的环形区，写满后覆盖最旧的记录*/
+/*append()只做内存拷贝，不发起系统调用；后台线程按flush_interval周期性msync*/
+/*进程崩溃时已写入的页仍在页缓存中；节点掉电时最多丢失最近一个flush_interval*/
+class NPUJournal
+{
+public:
+    explicit NPUJournal(std::chrono::milliseconds flush_interval = std::chrono::seconds(1));
+    ~NPUJournal();
+
+    NPUJournal(const NPUJournal&) = delete;
+    NPUJournal& operator=(const NPUJournal&) = delete;
+
+    /*打开（不存在或格式不符时重新创建）path并映射，bytes为文件大小；失败时返回false（采样不受影响）*/
+    bool open(const std::string& path, size_t bytes = NPU_JOURNAL_DEFAULT_BYTES);
+    /*最后一次msync并解除映射*/
+    void close();
+    bool is_open() const;
+
+    /*按时间顺序重放日志中的有效记录，每个周期调用一次visit，返回重放的周期数（应在append()之前调用）*/
+    size_t replay(const std::function<void(int64_t, const std::vector<NPULabel>&, const std::vector<NPUMetric>&)>& visit) const;
+
+    /*追加一个周期（每设备一条记录），在采样线程上调用；未打开时直接返回*/
+    void append(int64_t timestamp_ms, const std::vector<NPULabel>& labels, const std::vector<NPUMetric>& metrics);
+
+    /*记录容量*/
+    size_t capacity() const;
+
+private:
+    /*文件头（占文件首页）*/
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t record_num;
+        uint32_t metric_num;
+    };
+
+    std::chrono::milliseconds flush_interval_;
+    int fd_;
+    char* map_;
+    size_t map_size_;
+    NPUJournalRecord* records_;
+    size_t record_num_;
+    uint64_t next_seq_; //仅采样线程访问
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_;
+
+    /*后台刷盘线程*/
+    void run();
+};
+
+#endif // NPU_JOURNAL_H
@@ -0,0 +1,94 @@
+#ifndef NPU_LOGGER_H
+#define NPU_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "npu_mpsc_queue.h"
+
+/*一条日志（msg须为静态存储期字符串，入队时不拷贝）*/
+struct NPULogEntry
+{
+    const char* msg;
+    int ret;
+    int card;
+    int dev;
+    bool fatal;
+    bool info;  //状态变化通知（不是错误）：不聚合、不限速，按[INFO]输出
+};
+
+/*异步限速日志--采样线程只做一次无锁入队，后台线程负责聚合与输出*/
+/*相同的(msg, ret, card, dev)在repeat_interval内只输出一次，其余合并为计数；
+  全局输出不超过每秒max_lines_per_second行，超出的留到之后输出*/
+class NPULogger
+{
+public:
+    /*进程内唯一的日志器*/
+    static NPULogger& instance();
+
+    /*设置限速参数*/
+    void set_rate_limit(std::chrono::milliseconds repeat_interval, unsigned int max_lines_per_second);
+
+    /*记录一条日志：不阻塞、不分配内存，队列满时丢弃并计数*/
+    bool log(const char* msg, int ret, int card, int dev, bool fatal);
+    /*记录一条状态变化通知（如设备增减）：同样只做一次入队，但每条都输出*/
+    bool info(const char* msg, int card, int dev);
+
+    /*同步输出所有待输出内容（忽略限速，用于致命错误退出前）*/
+    void flush();
+
+    /*因队列满而丢弃的日志条数*/
+    uint64_t dropped() const;
+
+private:
+    NPULogger();
+    ~NPULogger();
+
+    /*聚合键与状态*/
+    struct Key
+    {
+        const char* msg;
+        int ret;
+        int card;
+        int dev;
+        bool operator<(const Key& o) const;
+    };
+    struct State
+    {
+        bool fatal;
+        uint64_t pending;  //尚未输出的次数
+        bool printed;      //是否已输出过
+        std::chrono::steady_clock::time_point last_print;
+    };
+
+    NPUMpscQueue<NPULogEntry> queue_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t dropped_reported_;
+
+    std::mutex mutex_; //保护以下聚合状态与配置（只在后台线程与flush()之间竞争）
+    std::map<Key, State> states_;
+    std::chrono::steady_clock::duration repeat_interval_;
+    unsigned int max_lines_per_second_;
+    double tokens_;
+    std::chrono::steady_clock::time_point last_refill_;
+
+    std::condition_variable cv_;
+    bool stopping_;
+    std::thread thread_;
+
+    /*后台线程主循环*/
+    void run();
+    /*取出队列中的日志并聚合，force为true时忽略限速全部输出（调用时持有mutex_）*/
+    void drain(bool force);
+    /*输出一行*/
+    void print(const Key& key, const State& state);
+    /*输出一条状态变化通知*/
+    void print_info(const NPULogEntry& entry);
+};
+
+#endif // NPU_LOGGER_H
@@ -1,6 +1,11 @@
 #ifndef NPU_METRICS_H
 #define NPU_METRICS_H
 
+#include <cstdint>
+
+/*单节点最多设备数（MAX_CARD_NUM张卡，每卡最多8个设备），用于预分配定长缓冲*/
+#define NPU_MAX_DEVICE_NUM 512
+
 /*标签结构体（用于标识设备）*/
 struct NPULabel
 {
@@ -29,6 +34,75 @@ struct NPUMetric
     int32_t temperature;
     //电压（V）
     double voltage;
+
+    //HBM
+    uint64_t hbm_total; //总容量（字节）
+    uint64_t hbm_used; //已用容量（字节）
+    int32_t hbm_temperature; //温度（C）
+    uint32_t util_hbm_bw; //带宽利用率（%）
+
+    //采样状态
+    //是否过期 (0: 本周期读数, 1: 未在截止时间内完成，沿用上次成功的读数)
+    uint32_t stale;
+    //最近一次读取失败的字段（NPU_METRIC_BIT掩码，0: 全部成功），失败的字段上报为0
+    uint32_t failed;
+};
+
+/*指标描述表：X(NPUMetric字段, Prometheus指标名, 帮助信息)
+  导出层按此表生成指标族，NPUMetric新增字段后在此登记即可导出*/
+#define NPU_METRIC_LIST(X) \
+    X(util_aicore, "npu_aicore_utilization_percent", "NPU AI Core utilization percentage") \
+    X(util_aicpu, "npu_aicpu_utilization_percent", "NPU AI CPU utilization percentage") \
+    X(util_mem, "npu_memory_utilization_percent", "NPU memory utilization percentage") \
+    X(aicore_freq, "npu_aicore_frequency_mhz", "NPU AI Core frequency in MHz") \
+    X(aicpu_freq, "npu_aicpu_frequency_mhz", "NPU AI CPU frequency in MHz") \
+    X(mem_freq, "npu_mem_frequency_mhz", "NPU mem frequency in MHz") \
+    X(power, "npu_power_watts", "NPU power consumption in watts") \
+    X(health, "npu_health", "NPU device health status (0:OK,1:WARN,2:ERROR,3:CRITICAL,0xFFFFFFFF:NOT_EXIST)") \
+    X(temperature, "npu_temperature_celsius", "NPU temperature in Celsius") \
+    X(voltage, "npu_voltage_volts", "NPU voltage in Volts") \
+    X(hbm_total, "npu_hbm_total_bytes", "NPU HBM capacity in bytes") \
+    X(hbm_used, "npu_hbm_used_bytes", "NPU HBM usage in bytes") \
+    X(hbm_temperature, "npu_hbm_temperature_celsius", "NPU HBM temperature in Celsius") \
+    X(util_hbm_bw, "npu_hbm_bandwidth_utilization_percent", "NPU HBM bandwidth utilization percentage") \
+    X(stale, "npu_sample_stale", "1 if the device missed the sampling deadline and reports its last good values") \
+    X(failed, "npu_sample_failed_fields", "Bitmask of fields whose last read failed and report 0 (bit i is the i-th npu_ metric in export order, starting from 0 for AI Core utilization)")
+
+/*指标编号（NPU_METRIC_<字段>）*/
+enum NPUMetricIndex
+{
+#define NPU_METRIC_INDEX(field, name, help) NPU_METRIC_##field,
+    NPU_METRIC_LIST(NPU_METRIC_INDEX)
+#undef NPU_METRIC_INDEX
+    NPU_METRIC_NUM
 };
+#define NPU_METRIC_BIT(field) (1u << NPU_METRIC_##field)
+static_assert(NPU_METRIC_NUM <= 32, "NPUMetric::failed has one bit per field");
+
+/*指标描述*/
+struct NPUMetricDesc
+{
+    const char* name;
+    const char* help;
+};
+
+/*按编号取指标描述*/
+inline const NPUMetricDesc& npu_metric_desc(int index)
+{
+    static const NPUMetricDesc descs[NPU_METRIC_NUM] = {
+#define NPU_METRIC_DESC(field, name, help) {name, help},
+        NPU_METRIC_LIST(NPU_METRIC_DESC)
+#undef NPU_METRIC_DESC
+    };
+    return descs[index];
+}
+
+/*按编号顺序把一个设备的全部指标转换为double*/
+inline void npu_metric_values(const NPUMetric& metric, double (&values)[NPU_METRIC_NUM])
+{
+#define NPU_METRIC_VALUE(field, name, help) values[NPU_METRIC_##field] = (double)metric.field;
+    NPU_METRIC_LIST(NPU_METRIC_VALUE)
+#undef NPU_METRIC_VALUE
+}
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,83 @@
+#ifndef NPU_MPSC_QUEUE_H
+#define NPU_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*有界无锁队列（多生产者/单消费者）--容量在构造时固定，之后不再分配内存*/
+/*基于每个槽位的序号实现（Vyukov有界队列），push()在队列满时立即返回false*/
+/*T需可平凡拷贝，模板类全部在头文件中实现*/
+template<typename T>
+class NPUMpscQueue
+{
+public:
+    /*capacity向上取整为2的幂*/
+    explicit NPUMpscQueue(size_t capacity)
+        : enqueue_pos_(0), dequeue_pos_(0)
+    {
+        size_t n = 2;
+        while (n < capacity)n <<= 1;
+        mask_ = n - 1;
+        cells_.reset(new Cell[n]);
+        for (size_t i = 0; i < n; i++)cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    NPUMpscQueue(const NPUMpscQueue&) = delete;
+    NPUMpscQueue& operator=(const NPUMpscQueue&) = delete;
+
+    /*生产者：入队，队列满时返回false（可在任意线程、信号回调中调用）*/
+    bool push(const T& value)
+    {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))break;
+            }
+            else if (dif < 0)return false;
+            else pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+        cell->value = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*消费者：出队，队列空时返回false（只能由单个线程调用）*/
+    bool pop(T& value)
+    {
+        Cell* cell = &cells_[dequeue_pos_ & mask_];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(dequeue_pos_ + 1) < 0)return false;
+        value = cell->value;
+        cell->seq.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        dequeue_pos_++;
+        return true;
+    }
+
+    /*容量*/
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    std::atomic<size_t> enqueue_pos_;
+    size_t dequeue_pos_; //仅消费者访问
+};
+
+#endif // NPU_MPSC_QUEUE_H
@@ -0,0 +1,25 @@
+#ifndef NPU_NET_COLLECTABLE_H
+#define NPU_NET_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_net_sampler.h"
+
+/*导出RoCE端口速率与PFC暂停占比（最近一个采样间隔）*/
+/*  NPU_NET_RATE_LIST中的各速率{card_id,device_id,port}                       gauge*/
+/*  npu_roce_pfc_pause_ratio{card_id,device_id,direction="tx|rx",priority}     gauge  暂停时间占比*/
+class NPUNetCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUNetCollectable(const NPUNetSampler& sampler);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUNetSampler& sampler_;
+};
+
+#endif // NPU_NET_COLLECTABLE_H
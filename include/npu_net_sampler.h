@@ -0,0 +1,133 @@
+#ifndef NPU_NET_SAMPLER_H
+#define NPU_NET_SAMPLER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "npu_metrics.h"
+
+#define NPU_NET_MAX_PORT_NUM 8  //每设备探测的RoCE端口号上限
+#define NPU_NET_PRIORITY_NUM 8  //PFC优先级数（与PRIORITY_NUM一致）
+
+/*端口速率：X(编号后缀, dcmi_network_pkt_stats_info中的累计计数字段, Prometheus指标名, 帮助信息)*/
+#define NPU_NET_RATE_LIST(X) \
+    X(TX_BYTES, mac_tx_total_oct_num, "npu_roce_tx_bytes_per_second", "NPU RoCE port transmit throughput in bytes per second") \
+    X(RX_BYTES, mac_rx_total_oct_num, "npu_roce_rx_bytes_per_second", "NPU RoCE port receive throughput in bytes per second") \
+    X(TX_PACKETS, mac_tx_total_pkt_num, "npu_roce_tx_packets_per_second", "NPU RoCE port transmitted packets per second") \
+    X(RX_PACKETS, mac_rx_total_pkt_num, "npu_roce_rx_packets_per_second", "NPU RoCE port received packets per second") \
+    X(TX_BAD_PACKETS, mac_tx_bad_pkt_num, "npu_roce_tx_bad_packets_per_second", "NPU RoCE port bad transmitted packets per second") \
+    X(RX_BAD_PACKETS, mac_rx_bad_pkt_num, "npu_roce_rx_bad_packets_per_second", "NPU RoCE port bad received packets per second") \
+    X(TX_PFC_PACKETS, mac_tx_pfc_pkt_num, "npu_roce_tx_pfc_packets_per_second", "NPU RoCE port transmitted PFC frames per second") \
+    X(RX_PFC_PACKETS, mac_rx_pfc_pkt_num, "npu_roce_rx_pfc_packets_per_second", "NPU RoCE port received PFC frames per second")
+
+/*速率编号（NPU_NET_RATE_<后缀>）*/
+enum NPUNetRate
+{
+#define NPU_NET_RATE_INDEX(id, field, name, help) NPU_NET_RATE_##id,
+    NPU_NET_RATE_LIST(NPU_NET_RATE_INDEX)
+#undef NPU_NET_RATE_INDEX
+    NPU_NET_RATE_NUM
+};
+
+/*一个端口最近一个间隔的速率*/
+struct NPUNetPortRates
+{
+    int port_id;
+    bool valid; //本间隔是否有速率（首次读数、读取失败或计数回绕时为false）
+    double rates[NPU_NET_RATE_NUM];
+};
+
+/*一个设备最近一个间隔的网络状态*/
+struct NPUNetDevice
+{
+    int card_id;
+    int device_id;
+    std::vector<NPUNetPortRates> ports;
+    bool pfc_valid;                                //本间隔是否有PFC暂停占比
+    double tx_pause_ratio[NPU_NET_PRIORITY_NUM];  //各优先级发送暂停的时间占比（0~1）
+    double rx_pause_ratio[NPU_NET_PRIORITY_NUM];  //各优先级接收暂停的时间占比
+    uint32_t pfc_priority_mask;                    //曾经出现过暂停的优先级（导出时只导出这些优先级）
+};
+
+/*RoCE端口吞吐与拥塞采样--独立线程每隔interval读取各端口的累计报文计数与各设备的PFC暂停时长，
+  由相邻两次读数的差值除以间隔得到速率和暂停占比（接口均不阻塞，不使用需要测量窗口的带宽接口）*/
+/*端口枚举缓存：设备首次出现时逐个探测端口号，之后只读取已知端口；端口读取失败时丢弃缓存，
+  至少间隔enumerate_retry后重新探测*/
+class NPUNetSampler
+{
+public:
+    explicit NPUNetSampler(std::chrono::milliseconds interval = std::chrono::seconds(5),
+                           std::chrono::milliseconds enumerate_retry = std::chrono::seconds(60));
+    ~NPUNetSampler();
+
+    NPUNetSampler(const NPUNetSampler&) = delete;
+    NPUNetSampler& operator=(const NPUNetSampler&) = delete;
+
+    /*设置采样的设备（可在任意线程调用，下一次采样生效）；保留的设备沿用其端口缓存与上次读数*/
+    void set_devices(const std::vector<NPULabel>& labels);
+
+    /*启动/停止采样线程*/
+    void start();
+    void stop();
+
+    /*在调用线程上采样一次全部设备（start()之前可用于同步采样）*/
+    void sample_once();
+
+    /*最近一次采样的结果（按设备顺序覆盖out）*/
+    void snapshot(std::vector<NPUNetDevice>& out) const;
+
+private:
+    /*单个端口的累计计数*/
+    struct Port
+    {
+        int port_id;
+        bool has_last;
+        uint64_t last[NPU_NET_RATE_NUM];
+        std::chrono::steady_clock::time_point last_time;
+    };
+
+    /*单个设备的采样状态（仅采样线程访问）*/
+    struct Device
+    {
+        NPULabel label;
+        bool enumerated;  //端口缓存是否有效
+        std::chrono::steady_clock::time_point enumerate_next; //最早的重新探测时刻
+        std::vector<Port> ports;
+        bool pfc_has_last;
+        uint64_t pfc_last_tx[NPU_NET_PRIORITY_NUM];
+        uint64_t pfc_last_rx[NPU_NET_PRIORITY_NUM];
+        std::chrono::steady_clock::time_point pfc_last_time;
+        NPUNetDevice result;
+    };
+
+    std::chrono::milliseconds interval_;
+    std::chrono::milliseconds enumerate_retry_;
+
+    mutable std::mutex mutex_; //保护发布的结果与待切换的设备集
+    std::vector<NPUNetDevice> published_;
+    std::vector<NPULabel> pending_labels_;
+    bool pending_;
+
+    std::vector<std::unique_ptr<Device>> devices_; //仅采样线程访问
+
+    std::thread thread_;
+    std::mutex run_mutex_;
+    std::condition_variable cv_;
+    bool running_;
+
+    /*切换到pending_labels_*/
+    void apply_devices();
+    /*探测设备的端口号并建立端口缓存*/
+    void enumerate_ports(Device& device, std::chrono::steady_clock::time_point now);
+    /*采样设备的端口计数与PFC暂停时长*/
+    void sample_device(Device& device);
+    /*采样线程主循环*/
+    void run();
+};
+
+#endif // NPU_NET_SAMPLER_H
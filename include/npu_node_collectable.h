@@ -0,0 +1,68 @@
+#ifndef NPU_NODE_COLLECTABLE_H
+#define NPU_NODE_COLLECTABLE_H
+
+#include <memory>
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_columns.h"
+
+/*节点级汇总指标--抓取时读取最新周期的列式读数并计算，无标签，每项一个序列*/
+/*  npu_node_devices                            gauge*/
+/*  npu_node_devices_failed                     gauge  有字段读取失败的设备数*/
+/*  npu_node_power_watts                        gauge  总功耗*/
+/*  npu_node_temperature_max_celsius            gauge*/
+/*  npu_node_aicore_utilization_mean_percent    gauge*/
+/*  npu_node_aicore_utilization_min_percent     gauge*/
+/*温度与利用率只汇总该字段读取成功的设备，没有这样的设备时不导出该项*/
+/*S需提供 bool columns(NPUColumns&) const（如NPUSampler<T>），模板类全部在头文件中实现*/
+template<typename S>
+class NPUNodeCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUNodeCollectable(const S& source) : source_(source) {}
+
+    std::vector<prometheus::MetricFamily> Collect() const override
+    {
+        std::vector<prometheus::MetricFamily> families;
+        std::unique_ptr<NPUColumns> columns(new NPUColumns());
+        if (!source_.columns(*columns))return families;
+
+        NPUNodeAggregate node;
+        npu_node_aggregate(*columns, node);
+        add(families, "npu_node_devices", "Number of NPU devices on the node", (double)node.devices);
+        if (node.devices == 0)return families;
+        add(families, "npu_node_devices_failed", "Number of NPU devices with a failed read of any metric",
+            (double)node.devices_failed);
+        add(families, "npu_node_power_watts", "Total NPU power consumption of the node in watts", node.power_sum);
+        if (node.temperature_devices > 0)
+        {
+            add(families, "npu_node_temperature_max_celsius", "Highest NPU temperature on the node in Celsius",
+                (double)node.temperature_max);
+        }
+        if (node.util_aicore_devices == 0)return families;
+        add(families, "npu_node_aicore_utilization_mean_percent", "Mean NPU AI Core utilization of the node",
+            node.util_aicore_mean);
+        add(families, "npu_node_aicore_utilization_min_percent", "Lowest NPU AI Core utilization on the node",
+            (double)node.util_aicore_min);
+        return families;
+    }
+
+private:
+    const S& source_;
+
+    static void add(std::vector<prometheus::MetricFamily>& families, const char* name, const char* help, double value)
+    {
+        prometheus::MetricFamily family;
+        family.name = name;
+        family.help = help;
+        family.type = prometheus::MetricType::Gauge;
+        family.metric.resize(1);
+        family.metric[0].gauge.value = value;
+        families.push_back(family);
+    }
+};
+
+#endif // NPU_NODE_COLLECTABLE_H
@@ -0,0 +1,24 @@
+#ifndef NPU_PCIE_COLLECTABLE_H
+#define NPU_PCIE_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_pcie_profiler.h"
+
+/*导出各设备最近一个PCIe测量窗口的结果，NPU_PCIE_FIELD_LIST中每项一个指标族（stat="min|max|avg"），
+  另有npu_pcie_window_timestamp_seconds{card_id,device_id}为成功窗口的结束时刻；测量失败的设备只导出时间戳*/
+class NPUPcieCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUPcieCollectable(const NPUPcieProfiler& profiler);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUPcieProfiler& profiler_;
+};
+
+#endif // NPU_PCIE_COLLECTABLE_H
@@ -0,0 +1,119 @@
+#ifndef NPU_PCIE_PROFILER_H
+#define NPU_PCIE_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "npu_metrics.h"
+#include "npu_worker_pool.h"
+
+/*PCIe测量项：X(dcmi_pcie_link_bandwidth_info字段, Prometheus指标名, 帮助信息)，每项有min/max/avg三个统计值*/
+#define NPU_PCIE_FIELD_LIST(X) \
+    X(tx_p_bw, "npu_pcie_tx_posted_bandwidth_megabytes_per_second", "NPU PCIe posted transmit bandwidth over the last profiling window in MB/s") \
+    X(tx_np_bw, "npu_pcie_tx_non_posted_bandwidth_megabytes_per_second", "NPU PCIe non-posted transmit bandwidth over the last profiling window in MB/s") \
+    X(tx_cpl_bw, "npu_pcie_tx_completion_bandwidth_megabytes_per_second", "NPU PCIe completion transmit bandwidth over the last profiling window in MB/s") \
+    X(tx_np_lantency, "npu_pcie_tx_non_posted_latency_microseconds", "NPU PCIe non-posted transmit latency over the last profiling window in microseconds") \
+    X(rx_p_bw, "npu_pcie_rx_posted_bandwidth_megabytes_per_second", "NPU PCIe posted receive bandwidth over the last profiling window in MB/s") \
+    X(rx_np_bw, "npu_pcie_rx_non_posted_bandwidth_megabytes_per_second", "NPU PCIe non-posted receive bandwidth over the last profiling window in MB/s") \
+    X(rx_cpl_bw, "npu_pcie_rx_completion_bandwidth_megabytes_per_second", "NPU PCIe completion receive bandwidth over the last profiling window in MB/s")
+
+/*测量项编号（NPU_PCIE_<字段>）*/
+enum NPUPcieField
+{
+#define NPU_PCIE_FIELD_INDEX(field, name, help) NPU_PCIE_##field,
+    NPU_PCIE_FIELD_LIST(NPU_PCIE_FIELD_INDEX)
+#undef NPU_PCIE_FIELD_INDEX
+    NPU_PCIE_FIELD_NUM
+};
+
+/*驱动给出的统计值（与dcmi_pcie_link_bandwidth_info中数组的顺序一致）*/
+enum NPUPcieStat
+{
+    NPU_PCIE_STAT_MIN,
+    NPU_PCIE_STAT_MAX,
+    NPU_PCIE_STAT_AVG,
+    NPU_PCIE_STAT_NUM
+};
+
+/*一个设备最近一个测量窗口的PCIe带宽与时延*/
+struct NPUPcieLink
+{
+    int card_id;
+    int device_id;
+    bool valid;           //最近一个窗口是否测量成功（失败或超时时values为上一次成功的结果）
+    int64_t timestamp_ms; //成功窗口的结束时刻（Unix毫秒，0表示尚无）
+    uint32_t values[NPU_PCIE_FIELD_NUM][NPU_PCIE_STAT_NUM];
+};
+
+/*PCIe链路带宽/时延测量--dcmi_get_pcie_link_bandwidth_info在profiling_time窗口内阻塞*/
+/*独立线程错峰测量：同一时刻只有一个设备处于测量窗口，避免共用PCIe交换芯片的设备相互干扰；
+  每轮在interval内把各设备的窗口均匀错开（设备多到排不下时首尾相接），每个窗口结束后立即发布该设备的结果*/
+/*驱动调用在单独的工作线程上进行：超过窗口长度加宽限仍未返回时该设备本窗口记为失败，
+  工作线程返回前其余设备不再分发（同样记为失败），测量线程与stop()不被卡住的调用阻塞*/
+class NPUPcieProfiler
+{
+public:
+    /*构造函数：window为测量窗口（profiling_time），interval为同一设备两次测量的目标间隔*/
+    explicit NPUPcieProfiler(std::chrono::milliseconds window = std::chrono::milliseconds(1000),
+                             std::chrono::milliseconds interval = std::chrono::seconds(60));
+    ~NPUPcieProfiler();
+
+    NPUPcieProfiler(const NPUPcieProfiler&) = delete;
+    NPUPcieProfiler& operator=(const NPUPcieProfiler&) = delete;
+
+    /*设置测量的设备（可在任意线程调用，下一轮生效）；保留的设备沿用其结果*/
+    void set_devices(const std::vector<NPULabel>& labels);
+
+    /*启动/停止后台线程（stop()等待正在进行的窗口结束，至多窗口长度加宽限）*/
+    void start();
+    void stop();
+
+    /*在调用线程上逐个测量全部设备（阻塞约设备数*window），start()之前可用于同步测量*/
+    void profile_once();
+
+    /*各设备最近的结果（按设备顺序覆盖out）*/
+    void snapshot(std::vector<NPUPcieLink>& out) const;
+
+private:
+    std::chrono::milliseconds window_;
+    std::chrono::milliseconds interval_;
+
+    mutable std::mutex mutex_; //保护发布的结果与待切换的设备集
+    std::vector<NPUPcieLink> links_;
+    std::vector<NPULabel> pending_labels_;
+    bool pending_;
+
+    /*测量工作区：发起线程只在工作线程空闲时写入任务，工作线程写入结果*/
+    NPULabel job_label_;
+    std::atomic<uint64_t> job_seq_;  //当前分发的测量编号
+    uint64_t measure_seq_;
+    NPUPcieLink result_;
+    std::atomic<uint64_t> done_;     //最近完成的测量编号
+    std::unique_ptr<NPUWorkerPool> pool_; //单个工作线程执行驱动调用
+    std::function<void(size_t)> task_;
+
+    std::thread thread_;
+    std::mutex run_mutex_;
+    std::condition_variable cv_;
+    bool running_;
+
+    /*切换到pending_labels_，返回设备数*/
+    size_t apply_devices();
+    /*测量第index个设备并发布（有超时）*/
+    void measure(size_t index);
+    /*工作线程任务：按job_label_调用驱动，结果写入result_*/
+    void measure_job();
+    /*等待到deadline，stop()时返回false*/
+    bool wait_until(std::chrono::steady_clock::time_point deadline);
+    /*后台线程主循环*/
+    void run();
+};
+
+#endif // NPU_PCIE_PROFILER_H
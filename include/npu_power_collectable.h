@@ -0,0 +1,26 @@
+#ifndef NPU_POWER_COLLECTABLE_H
+#define NPU_POWER_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_power_sampler.h"
+
+/*导出高频功耗采样最近一个完成的窗口的统计（窗口由采样器按固定长度轮转，Collect()只读取）*/
+/*  npu_power_window_{min,max,mean,p99}_watts{card_id,device_id}  gauge*/
+/*  npu_power_window_samples{card_id,device_id}                    gauge*/
+/*  npu_energy_joules_total{card_id,device_id}                     counter*/
+class NPUPowerCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUPowerCollectable(const NPUPowerSampler& sampler);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUPowerSampler& sampler_;
+};
+
+#endif // NPU_POWER_COLLECTABLE_H
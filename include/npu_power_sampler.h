@@ -0,0 +1,109 @@
+#ifndef NPU_POWER_SAMPLER_H
+#define NPU_POWER_SAMPLER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "npu_metrics.h"
+
+#define NPU_POWER_WINDOW_SAMPLES 2048 //每设备保留的窗口内原始读数（100Hz下约20秒），用于p99
+
+/*一个设备在一个窗口内的功耗统计*/
+struct NPUPowerWindow
+{
+    int card_id;
+    int device_id;
+    int64_t timestamp_ms; //窗口结束时刻（Unix毫秒）
+    uint32_t samples; //窗口内成功的读数（为0时min/max/mean/p99无意义）
+    double min_watts;
+    double max_watts;
+    double mean_watts;
+    double p99_watts;     //窗口超过NPU_POWER_WINDOW_SAMPLES个读数时，取最近的NPU_POWER_WINDOW_SAMPLES个
+    double energy_joules; //自设备加入起到窗口结束时累计的能耗（单调递增，不随窗口清零；读取失败的时段不计入）
+};
+
+/*高频功耗采样--独立线程以固定频率（默认100Hz）逐设备调用dcmi_get_device_power_info，
+  按固定长度的窗口（默认10秒）统计min/max/mean/p99，并按梯形法积分能耗*/
+/*窗口由采样线程自己轮转，与抓取无关：多个抓取方、重复渲染读到的都是同一个最近完成的窗口*/
+/*每设备的存储在加入时一次分配、大小固定（约4KB），与采样频率和窗口长度无关*/
+class NPUPowerSampler
+{
+public:
+    /*构造函数：hz为采样频率，window为统计窗口长度（超过NPU_POWER_WINDOW_SAMPLES/hz时p99只取最近的读数）*/
+    explicit NPUPowerSampler(unsigned int hz = 100, std::chrono::milliseconds window = std::chrono::seconds(10));
+    ~NPUPowerSampler();
+
+    NPUPowerSampler(const NPUPowerSampler&) = delete;
+    NPUPowerSampler& operator=(const NPUPowerSampler&) = delete;
+
+    /*设置采样的设备（可在任意线程调用，下一次采样生效）；保留的设备沿用其能耗累计*/
+    void set_devices(const std::vector<NPULabel>& labels);
+
+    /*启动/停止采样线程*/
+    void start();
+    void stop();
+
+    /*在调用线程上采样一次全部设备（start()之前可用于同步采样）*/
+    void sample_once();
+
+    /*结束当前窗口并发布其统计，开始新窗口（采样线程每个window调用一次；只应在采样线程未运行时手动调用）*/
+    void rotate_windows();
+
+    /*最近一个完成的窗口的统计（按设备顺序覆盖out，尚无完成的窗口时为空），不影响窗口*/
+    void windows(std::vector<NPUPowerWindow>& out) const;
+
+    /*采样频率*/
+    unsigned int rate() const;
+    /*窗口长度*/
+    std::chrono::milliseconds window() const;
+
+private:
+    /*单个设备的定长状态*/
+    struct Device
+    {
+        NPULabel label;
+        uint16_t ring[NPU_POWER_WINDOW_SAMPLES]; //窗口内读数（0.1W），超出后循环覆盖
+        uint32_t count;   //窗口内读数
+        uint64_t sum;
+        uint16_t min;
+        uint16_t max;
+        double energy_joules;
+        bool has_last;    //是否有上一次读数（用于积分，读取失败时清除）
+        uint16_t last;
+        std::chrono::steady_clock::time_point last_time;
+    };
+
+    unsigned int hz_;
+    std::chrono::steady_clock::duration period_;
+    std::chrono::milliseconds window_;
+
+    mutable std::mutex mutex_; //保护以下设备状态、待切换的设备集与已完成的窗口
+    std::vector<std::unique_ptr<Device>> devices_;
+    std::vector<NPULabel> pending_labels_;
+    bool pending_;
+    std::vector<NPUPowerWindow> completed_;
+
+    std::vector<uint16_t> rotate_values_; //p99的排序缓冲，仅采样线程访问
+
+    /*采样线程的工作区（大小随设备数变化，稳定后不再分配）*/
+    std::vector<NPULabel> tick_labels_;
+    std::vector<int> tick_power_;
+    std::vector<std::chrono::steady_clock::time_point> tick_time_;
+
+    std::thread thread_;
+    std::mutex run_mutex_;
+    std::condition_variable cv_;
+    bool running_;
+
+    /*切换到pending_labels_（调用时持有mutex_）*/
+    void apply_devices();
+    /*采样线程主循环*/
+    void run();
+};
+
+#endif // NPU_POWER_SAMPLER_H
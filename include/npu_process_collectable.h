@@ -0,0 +1,26 @@
+#ifndef NPU_PROCESS_COLLECTABLE_H
+#define NPU_PROCESS_COLLECTABLE_H
+
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_process_sampler.h"
+
+/*导出进程级设备内存（最近一次读取）*/
+/*  npu_process_memory_bytes{card_id,device_id,pid}    gauge  占用最多的top_k个进程*/
+/*  npu_process_memory_other_bytes{card_id,device_id}  gauge  其余进程之和*/
+/*  npu_process_count{card_id,device_id}               gauge  设备上的进程总数*/
+class NPUProcessCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUProcessCollectable(const NPUProcessSampler& sampler);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    const NPUProcessSampler& sampler_;
+};
+
+#endif // NPU_PROCESS_COLLECTABLE_H
@@ -0,0 +1,83 @@
+#ifndef NPU_PROCESS_SAMPLER_H
+#define NPU_PROCESS_SAMPLER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "npu_metrics.h"
+
+#define NPU_PROCESS_MAX_NUM 64 //每设备一次读取的进程数上限（dcmi_get_device_resource_info的缓冲区大小）
+
+/*一个进程占用的设备内存*/
+struct NPUProcessMemory
+{
+    int pid;
+    uint64_t bytes;
+};
+
+/*一个设备最近一次读取的进程内存：占用最多的top_k个进程单列，其余合并为other*/
+struct NPUProcessDevice
+{
+    int card_id;
+    int device_id;
+    bool valid;                            //最近一次读取是否成功（失败时不导出该设备）
+    std::vector<NPUProcessMemory> top;     //按占用从大到小，至多top_k个
+    uint32_t process_num;                  //设备上的进程总数
+    uint32_t other_num;                    //未单列的进程数
+    uint64_t other_bytes;                  //未单列进程的内存之和
+};
+
+/*进程级设备内存归属--独立线程每隔interval逐设备调用dcmi_get_device_resource_info*/
+/*pid作为标签时序列数不可控：每设备只单列top_k个进程，其余合并为other，
+  序列数上限为设备数*(top_k+2)（top_k个进程、other与进程总数各一个）；
+  每次读取整体替换上一次的结果，已退出进程的序列在下一个间隔即消失*/
+class NPUProcessSampler
+{
+public:
+    explicit NPUProcessSampler(std::chrono::milliseconds interval = std::chrono::seconds(5), size_t top_k = 5);
+    ~NPUProcessSampler();
+
+    NPUProcessSampler(const NPUProcessSampler&) = delete;
+    NPUProcessSampler& operator=(const NPUProcessSampler&) = delete;
+
+    /*设置读取的设备（可在任意线程调用，下一次读取生效）*/
+    void set_devices(const std::vector<NPULabel>& labels);
+
+    /*启动/停止读取线程*/
+    void start();
+    void stop();
+
+    /*在调用线程上读取一次全部设备（start()之前可用于同步读取）*/
+    void sample_once();
+
+    /*最近一次读取的结果（按设备顺序覆盖out）*/
+    void snapshot(std::vector<NPUProcessDevice>& out) const;
+
+    size_t top_k() const;
+
+private:
+    std::chrono::milliseconds interval_;
+    size_t top_k_;
+
+    mutable std::mutex mutex_; //保护发布的结果与设备集
+    std::vector<NPUProcessDevice> published_;
+    std::vector<NPULabel> labels_;
+
+    std::vector<NPUProcessMemory> procs_; //读取缓冲，仅读取线程访问
+
+    std::thread thread_;
+    std::mutex run_mutex_;
+    std::condition_variable cv_;
+    bool running_;
+
+    /*读取一个设备并按top_k归并到out*/
+    void sample_device(const NPULabel& label, NPUProcessDevice& out);
+    /*读取线程主循环*/
+    void run();
+};
+
+#endif // NPU_PROCESS_SAMPLER_H
@@ -0,0 +1,237 @@
+#ifndef NPU_SAMPLER_H
+#define NPU_SAMPLER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "npu_columns.h"
+#include "npu_metrics.h"
+
+/*一次完整采样周期的快照*/
+struct NPUSnapshot
+{
+    uint64_t cycle;        //采样周期编号（从1开始，0表示尚无数据）
+    int64_t timestamp_ms;  //周期完成时刻（Unix毫秒）
+    std::vector<NPULabel> labels;
+    std::vector<NPUMetric> metrics;
+};
+
+/*后台采样器--独立线程按固定间隔调用impl采样，并以双缓冲+顺序锁（seqlock）发布快照*/
+/*读者无锁、不等待驱动，总能读到同一周期内所有设备的一致数据*/
+/*T需提供 labels() 与 sample(std::vector<NPUMetric>&)，模板类全部在头文件中实现*/
+template<typename T>
+class NPUSampler
+{
+public:
+    /*快照读者：以NPUCollector所需的labels()/sample()接口暴露最新快照*/
+    /*每个读者线程各用一个Reader，labels()读取新快照，随后的sample()返回同一快照的数据*/
+    class Reader
+    {
+    public:
+        explicit Reader(const NPUSampler& sampler) : sampler_(sampler)
+        {
+            snapshot_.cycle = 0;
+            snapshot_.timestamp_ms = 0;
+        }
+
+        const std::vector<NPULabel>& labels()
+        {
+            sampler_.snapshot(snapshot_);
+            return snapshot_.labels;
+        }
+
+        void sample(std::vector<NPUMetric>& metrics)
+        {
+            metrics = snapshot_.metrics;
+        }
+
+        /*最近一次labels()读到的快照*/
+        const NPUSnapshot& snapshot() const { return snapshot_; }
+
+    private:
+        const NPUSampler& sampler_;
+        NPUSnapshot snapshot_;
+    };
+
+    /*构造函数：interval为采样周期*/
+    NPUSampler(T& impl, std::chrono::milliseconds interval)
+        : impl_(impl), interval_(interval), front_(-1), published_cycle_(0), running_(false)
+    {
+        buffers_[0].reset(new Buffer());
+        buffers_[1].reset(new Buffer());
+        work_.reserve(NPU_MAX_DEVICE_NUM);
+    }
+
+    ~NPUSampler()
+    {
+        stop();
+    }
+
+    NPUSampler(const NPUSampler&) = delete;
+    NPUSampler& operator=(const NPUSampler&) = delete;
+
+    /*启动采样线程*/
+    void start()
+    {
+        if (running_)return;
+        running_ = true;
+        thread_ = std::thread(&NPUSampler::run, this);
+    }
+
+    /*停止采样线程（等待当前周期结束）*/
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)return;
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())thread_.join();
+    }
+
+    /*设置周期回调：每个周期发布后在采样线程上以周期编号调用（应在start()之前设置）*/
+    void set_cycle_callback(std::function<void(uint64_t)> callback)
+    {
+        cycle_callback_ = callback;
+    }
+
+    /*在调用线程上执行一个采样周期并发布（start()之前可用于同步采样）*/
+    void sample_once()
+    {
+        const auto& label_list = impl_.labels();
+        impl_.sample(work_);
+        publish(label_list, work_);
+        if (cycle_callback_)cycle_callback_(cycle_);
+    }
+
+    /*最近发布的周期编号（0表示尚无数据）*/
+    uint64_t cycle() const
+    {
+        return published_cycle_.load(std::memory_order_acquire);
+    }
+
+    /*无锁读取最新快照到out，尚无数据时返回false*/
+    bool snapshot(NPUSnapshot& out) const
+    {
+        while (true)
+        {
+            int front = front_.load(std::memory_order_acquire);
+            if (front < 0)return false;
+            const Buffer& buf = *buffers_[front];
+
+            uint64_t seq0 = buf.seq.load(std::memory_order_acquire);
+            if (seq0 & 1)continue; //写者正在改写该缓冲（读者落后了整整一个周期），重试
+
+            size_t count = buf.count;
+            if (count > NPU_MAX_DEVICE_NUM)continue;
+            out.cycle = buf.cycle;
+            out.timestamp_ms = buf.timestamp_ms;
+            out.labels.resize(count);
+            out.metrics.resize(count);
+            std::memcpy(out.labels.data(), buf.labels, count * sizeof(NPULabel));
+            std::memcpy(out.metrics.data(), buf.metrics, count * sizeof(NPUMetric));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buf.seq.load(std::memory_order_relaxed) == seq0)return true;
+        }
+    }
+
+    /*无锁读取最新周期的列式读数到out（各列下标与同周期snapshot()的labels一致），尚无数据时返回false*/
+    bool columns(NPUColumns& out) const
+    {
+        while (true)
+        {
+            int front = front_.load(std::memory_order_acquire);
+            if (front < 0)return false;
+            const Buffer& buf = *buffers_[front];
+
+            uint64_t seq0 = buf.seq.load(std::memory_order_acquire);
+            if (seq0 & 1)continue;
+
+            npu_columns_copy(out, buf.columns);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buf.seq.load(std::memory_order_relaxed) == seq0)return true;
+        }
+    }
+
+private:
+    /*预分配的定长快照缓冲*/
+    struct Buffer
+    {
+        std::atomic<uint64_t> seq{0};  //顺序号：奇数表示写入中
+        uint64_t cycle = 0;
+        int64_t timestamp_ms = 0;
+        size_t count = 0;
+        NPULabel labels[NPU_MAX_DEVICE_NUM];
+        NPUMetric metrics[NPU_MAX_DEVICE_NUM];
+        NPUColumns columns; //同一周期的列式读数，发布时由metrics转置
+    };
+
+    T& impl_;
+    std::chrono::milliseconds interval_;
+
+    std::unique_ptr<Buffer> buffers_[2];
+    std::atomic<int> front_;  //最新已发布的缓冲下标（-1：尚无）
+    std::atomic<uint64_t> published_cycle_;
+    uint64_t cycle_ = 0;      //仅采样线程访问
+    std::vector<NPUMetric> work_; //采样工作区：采样期间驱动调用可能很慢，不能占用对读者可见的缓冲
+    std::function<void(uint64_t)> cycle_callback_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_;
+
+    /*把一个完整周期写入后台缓冲并原子切换为前台*/
+    void publish(const std::vector<NPULabel>& label_list, const std::vector<NPUMetric>& metric_list)
+    {
+        int front = front_.load(std::memory_order_relaxed);
+        int back = front == 0 ? 1 : 0;
+        Buffer& buf = *buffers_[back];
+        size_t count = std::min(label_list.size(), (size_t)NPU_MAX_DEVICE_NUM);
+
+        buf.seq.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        buf.cycle = ++cycle_;
+        buf.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        buf.count = count;
+        std::memcpy(buf.labels, label_list.data(), count * sizeof(NPULabel));
+        std::memcpy(buf.metrics, metric_list.data(), count * sizeof(NPUMetric));
+        npu_columns_fill(buf.columns, metric_list.data(), count);
+        buf.seq.fetch_add(1, std::memory_order_release);
+
+        front_.store(back, std::memory_order_release);
+        published_cycle_.store(cycle_, std::memory_order_release);
+    }
+
+    /*采样线程主循环：按固定节拍采样，stop()可随时打断等待*/
+    void run()
+    {
+        auto next = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_)
+        {
+            lock.unlock();
+            sample_once();
+            lock.lock();
+
+            next += interval_;
+            auto now = std::chrono::steady_clock::now();
+            if (next < now)next = now; //周期超时则不补采
+            cv_.wait_until(lock, next, [this] { return !running_; });
+        }
+    }
+};
+
+#endif // NPU_SAMPLER_H
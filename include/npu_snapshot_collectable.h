@@ -0,0 +1,61 @@
+#ifndef NPU_SNAPSHOT_COLLECTABLE_H
+#define NPU_SNAPSHOT_COLLECTABLE_H
+
+#include <string>
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+#include "npu_sampler.h"
+
+/*零Registry的Prometheus收集器--抓取时直接由最新NPUSnapshot生成MetricFamily*/
+/*不在Registry中保存任何序列：省去每周期一次的数据拷贝和逐序列加锁*/
+/*S需提供 bool snapshot(NPUSnapshot&) const（如NPUSampler<T>），模板类全部在头文件中实现*/
+template<typename S>
+class NPUSnapshotCollectable : public prometheus::Collectable
+{
+public:
+    explicit NPUSnapshotCollectable(const S& source) : source_(source) {}
+
+    /*抓取时调用：读取最新快照并按指标描述表生成各指标族*/
+    std::vector<prometheus::MetricFamily> Collect() const override
+    {
+        NPUSnapshot snap;
+        std::vector<prometheus::MetricFamily> families(NPU_METRIC_NUM);
+        for (int k = 0; k < NPU_METRIC_NUM; k++)
+        {
+            families[k].name = npu_metric_desc(k).name;
+            families[k].help = npu_metric_desc(k).help;
+            families[k].type = prometheus::MetricType::Gauge;
+        }
+        if (!source_.snapshot(snap))return families;
+
+        for (int k = 0; k < NPU_METRIC_NUM; k++)families[k].metric.resize(snap.labels.size());
+
+        double values[NPU_METRIC_NUM];
+        for (size_t i = 0; i < snap.labels.size(); i++)
+        {
+            //每个设备的标签只构造一次，再复制到各指标族
+            std::vector<prometheus::ClientMetric::Label> label(2);
+            label[0].name = "card_id";
+            label[0].value = std::to_string(snap.labels[i].card_id);
+            label[1].name = "device_id";
+            label[1].value = std::to_string(snap.labels[i].device_id);
+
+            npu_metric_values(snap.metrics[i], values);
+            for (int k = 0; k < NPU_METRIC_NUM; k++)
+            {
+                prometheus::ClientMetric& metric = families[k].metric[i];
+                metric.label = label;
+                metric.gauge.value = values[k];
+            }
+        }
+        return families;
+    }
+
+private:
+    const S& source_;
+};
+
+#endif // NPU_SNAPSHOT_COLLECTABLE_H
@@ -0,0 +1,65 @@
+#ifndef NPU_WORKER_POOL_H
+#define NPU_WORKER_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*固定大小的工作线程池--每个工作线程有固定编号，run()把同一任务分发给所有线程*/
+class NPUWorkerPool
+{
+public:
+    /*构造函数：创建workers个常驻工作线程；stop_timeout为析构时等待仍在执行的任务的上限*/
+    explicit NPUWorkerPool(size_t workers, std::chrono::milliseconds stop_timeout = std::chrono::seconds(1));
+    /*析构函数：通知并回收所有工作线程；等待stop_timeout后仍卡在任务中的线程（如驱动调用不返回）被分离，
+      不阻塞退出。被分离的线程在任务返回后即结束，此后任务引用的对象可能已销毁，只应发生在进程退出时*/
+    ~NPUWorkerPool();
+
+    NPUWorkerPool(const NPUWorkerPool&) = delete;
+    NPUWorkerPool& operator=(const NPUWorkerPool&) = delete;
+
+    /*工作线程数量*/
+    size_t size() const;
+
+    /*是否所有工作线程都空闲（没有超时后仍在执行的任务）*/
+    bool idle();
+
+    /*第i个工作线程执行task(i)，全部完成后返回*/
+    void run(const std::function<void(size_t)>& task);
+
+    /*只向空闲的工作线程分发task，最多等到deadline
+      超时仍未完成的线程继续执行，在其完成前不会再被分发；task须在此期间保持有效
+      返回本轮分发的线程是否全部按时完成*/
+    bool run_until(const std::function<void(size_t)>& task, std::chrono::steady_clock::time_point deadline);
+
+private:
+    /*调度状态：由线程池与各工作线程共同持有，被分离的线程在线程池析构后仍可安全访问*/
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable start_cv; //通知工作线程开始新一轮或退出
+        std::condition_variable done_cv;  //通知调用者本轮结束或有线程空闲
+
+        std::vector<const std::function<void(size_t)>*> tasks; //各线程被分发的任务
+        std::vector<uint64_t> job_round; //各线程被分发任务时的轮次，0表示从未分发
+        std::vector<bool> busy;          //各线程是否正在执行任务
+        uint64_t round = 0;   //当前轮次编号
+        size_t pending = 0;   //本轮尚未完成的线程数
+        bool stopping = false;
+    };
+
+    std::vector<std::thread> threads_;
+    std::shared_ptr<State> state_;
+    std::chrono::milliseconds stop_timeout_;
+
+    /*工作线程主循环*/
+    static void worker_loop(std::shared_ptr<State> state, size_t id);
+};
+
+#endif // NPU_WORKER_POOL_H
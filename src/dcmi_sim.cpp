@@ -0,0 +1,488 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "dcmi_sim.h"
+
+namespace {
+
+/*当前配置（由dcmi_init/dcmi_sim_set_config整体替换）：发布后不再修改的快照，
+  调用路径用std::atomic_load取得一份，读取期间配置被替换也不受影响*/
+std::shared_ptr<const dcmi_sim_config> g_config =
+    std::make_shared<const dcmi_sim_config>(dcmi_sim_config{1, 1, 0, 0, 0.0, DCMI_ERR_CODE_INNER_ERR, 1});
+std::mutex g_config_mutex; //串行化写者
+
+std::shared_ptr<const dcmi_sim_config> current_config()
+{
+    return std::atomic_load(&g_config);
+}
+
+/*定向故障表*/
+struct SimFault
+{
+    dcmi_sim_call call;
+    int card_id;
+    int device_id;
+    int ret;
+    unsigned int delay_us;
+};
+SimFault g_faults[DCMI_SIM_MAX_FAULT_NUM];
+std::atomic<int> g_fault_num{0};
+std::mutex g_fault_mutex;
+
+std::atomic<unsigned long long> g_call_count{0};
+
+/*故障事件订阅*/
+std::atomic<dcmi_fault_event_callback> g_fault_handler{nullptr};
+std::atomic<int> g_event_serial{0};
+std::atomic<unsigned int> g_thread_seq{0};
+
+const std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+/*每个线程独立的xorshift随机数，避免调用之间争用*/
+unsigned long long next_random()
+{
+    thread_local unsigned long long state = 0;
+    if (state == 0)
+    {
+        state = ((unsigned long long)current_config()->seed << 32) ^ (0x9E3779B97F4A7C15ULL * (g_thread_seq++ + 1));
+        if (state == 0)state = 1;
+    }
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/*[0,1)均匀分布*/
+double next_uniform()
+{
+    return (double)(next_random() >> 11) / (double)(1ULL << 53);
+}
+
+int env_int(const char* name, int def)
+{
+    const char* v = std::getenv(name);
+    return v ? std::atoi(v) : def;
+}
+
+double env_double(const char* name, double def)
+{
+    const char* v = std::getenv(name);
+    return v ? std::atof(v) : def;
+}
+
+bool config_valid(const dcmi_sim_config& c)
+{
+    return c.card_num >= 1 && c.card_num <= MAX_CARD_NUM &&
+           c.device_num_per_card >= 1 && c.device_num_per_card <= DCMI_SIM_MAX_DEVICE_PER_CARD &&
+           c.error_rate >= 0.0 && c.error_rate <= 1.0;
+}
+
+void sleep_us(unsigned long long us)
+{
+    if (us > 0)std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+/*每次调用的公共处理：计数、延迟、随机失败和定向故障，返回非DCMI_OK时调用直接失败
+  随机失败只作用于设备级调用，枚举接口只受定向故障影响*/
+int enter_call(const dcmi_sim_config& config, dcmi_sim_call call, int card_id, int device_id)
+{
+    g_call_count.fetch_add(1, std::memory_order_relaxed);
+
+    unsigned long long delay = config.latency_us;
+    if (config.jitter_us > 0)delay += next_random() % (config.jitter_us + 1ULL);
+
+    int ret = DCMI_OK;
+    if (g_fault_num.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(g_fault_mutex);
+        int n = g_fault_num.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; i++)
+        {
+            const SimFault& f = g_faults[i];
+            if (f.call != DCMI_SIM_CALL_ANY && f.call != call)continue;
+            if (f.card_id >= 0 && f.card_id != card_id)continue;
+            if (f.device_id >= 0 && f.device_id != device_id)continue;
+            delay += f.delay_us;
+            if (ret == DCMI_OK)ret = f.ret;
+        }
+    }
+    sleep_us(delay);
+
+    if (ret == DCMI_OK && device_id >= 0 && config.error_rate > 0.0 && next_uniform() < config.error_rate)
+    {
+        ret = config.error_code;
+    }
+    return ret;
+}
+
+/*设备级调用：先校验卡/设备编号*/
+int enter_device_call(dcmi_sim_call call, int card_id, int device_id)
+{
+    std::shared_ptr<const dcmi_sim_config> config = current_config();
+    if (card_id < 0 || card_id >= config->card_num ||
+        device_id < 0 || device_id >= config->device_num_per_card)
+    {
+        g_call_count.fetch_add(1, std::memory_order_relaxed);
+        return DCMI_ERR_CODE_INVALID_DEVICE_ID;
+    }
+    return enter_call(*config, call, card_id, device_id);
+}
+
+/*模拟的时变读数：以设备编号为相位的慢速正弦波*/
+double wave(int card_id, int device_id, double period_s)
+{
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_start).count();
+    double phase = (double)(card_id * DCMI_SIM_MAX_DEVICE_PER_CARD + device_id) * 0.7;
+    return 0.5 + 0.5 * std::sin(2.0 * M_PI * t / period_s + phase);
+}
+
+/*wave()从0到当前时刻的积分乘以rate：随时间单调不减的累计计数，增速按wave()变化*/
+unsigned long long ramp(int card_id, int device_id, double period_s, double rate)
+{
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_start).count();
+    double phase = (double)(card_id * DCMI_SIM_MAX_DEVICE_PER_CARD + device_id) * 0.7;
+    double w = 2.0 * M_PI / period_s;
+    return (unsigned long long)(rate * (0.5 * t - 0.5 / w * (std::cos(w * t + phase) - std::cos(phase))));
+}
+
+} // namespace
+
+extern "C" {
+
+int dcmi_init(void)
+{
+    dcmi_sim_config c;
+    c.card_num = env_int("NPU_SIM_CARDS", 1);
+    c.device_num_per_card = env_int("NPU_SIM_DEVICES_PER_CARD", 1);
+    c.latency_us = (unsigned int)env_int("NPU_SIM_LATENCY_US", 0);
+    c.jitter_us = (unsigned int)env_int("NPU_SIM_JITTER_US", 0);
+    c.error_rate = env_double("NPU_SIM_ERROR_RATE", 0.0);
+    c.error_code = env_int("NPU_SIM_ERROR_CODE", DCMI_ERR_CODE_INNER_ERR);
+    c.seed = (unsigned int)env_int("NPU_SIM_SEED", 1);
+    g_call_count.store(0);
+    return dcmi_sim_set_config(&c);
+}
+
+int dcmi_get_card_list(int *card_num, int *card_list, int list_len)
+{
+    if (card_num == NULL || card_list == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    std::shared_ptr<const dcmi_sim_config> config = current_config();
+    int ret = enter_call(*config, DCMI_SIM_CALL_CARD_LIST, -1, -1);
+    if (ret != DCMI_OK)return ret;
+    int n = config->card_num < list_len ? config->card_num : list_len;
+    for (int i = 0; i < n; i++)card_list[i] = i;
+    *card_num = n;
+    return DCMI_OK;
+}
+
+int dcmi_get_all_device_count(int *all_device_count)
+{
+    if (all_device_count == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    std::shared_ptr<const dcmi_sim_config> config = current_config();
+    int ret = enter_call(*config, DCMI_SIM_CALL_ALL_DEVICE_COUNT, -1, -1);
+    if (ret != DCMI_OK)return ret;
+    *all_device_count = config->card_num * config->device_num_per_card;
+    return DCMI_OK;
+}
+
+int dcmi_get_device_id_in_card(int card_id, int *device_id_max, int *mcu_id, int *cpu_id)
+{
+    if (device_id_max == NULL || mcu_id == NULL || cpu_id == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    std::shared_ptr<const dcmi_sim_config> config = current_config();
+    if (card_id < 0 || card_id >= config->card_num)return DCMI_ERR_CODE_INVALID_DEVICE_ID;
+    int ret = enter_call(*config, DCMI_SIM_CALL_DEVICE_ID_IN_CARD, card_id, -1);
+    if (ret != DCMI_OK)return ret;
+    *device_id_max = config->device_num_per_card;
+    *mcu_id = -1;
+    *cpu_id = -1;
+    return DCMI_OK;
+}
+
+int dcmi_get_device_utilization_rate(int card_id, int device_id, int input_type, unsigned int *utilization_rate)
+{
+    if (utilization_rate == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_UTILIZATION_RATE, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    *utilization_rate = (unsigned int)(100.0 * wave(card_id, device_id, 20.0 + input_type));
+    return DCMI_OK;
+}
+
+int dcmi_get_device_aicore_info(int card_id, int device_id, struct dcmi_aicore_info *aicore_info)
+{
+    if (aicore_info == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_AICORE_INFO, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    aicore_info->freq = 1800;
+    aicore_info->cur_freq = 1000 + (unsigned int)(800.0 * wave(card_id, device_id, 60.0));
+    return DCMI_OK;
+}
+
+int dcmi_get_device_aicpu_info(int card_id, int device_id, struct dcmi_aicpu_info *aicpu_info)
+{
+    if (aicpu_info == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_AICPU_INFO, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    std::memset(aicpu_info, 0, sizeof(*aicpu_info));
+    aicpu_info->max_freq = 1900;
+    aicpu_info->cur_freq = 1900;
+    aicpu_info->aicpu_num = 4;
+    return DCMI_OK;
+}
+
+int dcmi_get_device_frequency(int card_id, int device_id, enum dcmi_freq_type input_type, unsigned int *frequency)
+{
+    if (frequency == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_FREQUENCY, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    *frequency = input_type == DCMI_FREQ_HBM ? 1600 : 2666;
+    return DCMI_OK;
+}
+
+int dcmi_get_device_power_info(int card_id, int device_id, int *power)
+{
+    if (power == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_POWER_INFO, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //单位0.1W
+    *power = 800 + (int)(2200.0 * wave(card_id, device_id, 15.0));
+    return DCMI_OK;
+}
+
+int dcmi_get_device_hbm_info(int card_id, int device_id, struct dcmi_hbm_info *hbm_info)
+{
+    if (hbm_info == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_HBM_INFO, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //单位MB，64GB HBM
+    hbm_info->memory_size = 65536;
+    hbm_info->freq = 1600;
+    hbm_info->memory_usage = 4096 + (unsigned long long)(57344.0 * wave(card_id, device_id, 120.0));
+    hbm_info->temp = 45 + (int)(30.0 * wave(card_id, device_id, 90.0));
+    hbm_info->bandwith_util_rate = (unsigned int)(100.0 * wave(card_id, device_id, 30.0));
+    return DCMI_OK;
+}
+
+int dcmi_get_hccs_link_bandwidth_info(int card_id, int device_id, struct dcmi_hccs_bandwidth_info *hccs_bandwidth_info)
+{
+    if (hccs_bandwidth_info == NULL || hccs_bandwidth_info->profiling_time <= 0)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_HCCS_BANDWIDTH, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //与真实驱动一样在测量窗口内阻塞；PCS 1~7为HCCS链路
+    sleep_us((unsigned long long)hccs_bandwidth_info->profiling_time * 1000ULL);
+    hccs_bandwidth_info->total_txbw = 0;
+    hccs_bandwidth_info->total_rxbw = 0;
+    for (int p = 0; p < DCMI_HCCS_MAX_PCS_NUM; p++)
+    {
+        bool link = p >= 1 && p <= DCMI_HCCS_910B_PCS_NUM;
+        hccs_bandwidth_info->tx_bandwidth[p] = link ? 28000.0 * wave(card_id, device_id, 40.0 + p) : 0;
+        hccs_bandwidth_info->rx_bandwidth[p] = link ? 28000.0 * wave(card_id, device_id, 50.0 + p) : 0;
+        hccs_bandwidth_info->total_txbw += hccs_bandwidth_info->tx_bandwidth[p];
+        hccs_bandwidth_info->total_rxbw += hccs_bandwidth_info->rx_bandwidth[p];
+    }
+    return DCMI_OK;
+}
+
+int dcmi_get_pcie_link_bandwidth_info(int card_id, int device_id,
+    struct dcmi_pcie_link_bandwidth_info *pcie_link_bandwidth_info)
+{
+    if (pcie_link_bandwidth_info == NULL || pcie_link_bandwidth_info->profiling_time <= 0)
+    {
+        return DCMI_ERR_CODE_INVALID_PARAMETER;
+    }
+    int ret = enter_device_call(DCMI_SIM_CALL_PCIE_BANDWIDTH, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //与真实驱动一样在测量窗口内阻塞；各项按MIN/MAX/AVG填写
+    sleep_us((unsigned long long)pcie_link_bandwidth_info->profiling_time * 1000ULL);
+    double load = wave(card_id, device_id, 35.0);
+    unsigned int* fields[] = {
+        pcie_link_bandwidth_info->tx_p_bw, pcie_link_bandwidth_info->tx_np_bw, pcie_link_bandwidth_info->tx_cpl_bw,
+        pcie_link_bandwidth_info->rx_p_bw, pcie_link_bandwidth_info->rx_np_bw, pcie_link_bandwidth_info->rx_cpl_bw
+    };
+    for (unsigned int* f : fields)
+    {
+        f[2] = (unsigned int)(20000.0 * load);
+        f[0] = f[2] / 2;
+        f[1] = f[2] + f[2] / 2;
+    }
+    pcie_link_bandwidth_info->tx_np_lantency[2] = 2 + (unsigned int)(8.0 * load);
+    pcie_link_bandwidth_info->tx_np_lantency[0] = 1;
+    pcie_link_bandwidth_info->tx_np_lantency[1] = pcie_link_bandwidth_info->tx_np_lantency[2] * 3;
+    return DCMI_OK;
+}
+
+int dcmi_get_netdev_pkt_stats_info(int card_id, int device_id, int port_id,
+    struct dcmi_network_pkt_stats_info *network_pkt_stats_info)
+{
+    if (network_pkt_stats_info == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_NETDEV_PKT_STATS, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    if (port_id != 0)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    std::memset(network_pkt_stats_info, 0, sizeof(*network_pkt_stats_info));
+    //满载约25GB/s，平均报文4KB
+    network_pkt_stats_info->mac_tx_total_oct_num = ramp(card_id, device_id, 30.0, 25e9);
+    network_pkt_stats_info->mac_rx_total_oct_num = ramp(card_id, device_id, 33.0, 25e9);
+    network_pkt_stats_info->mac_tx_total_pkt_num = network_pkt_stats_info->mac_tx_total_oct_num / 4096;
+    network_pkt_stats_info->mac_rx_total_pkt_num = network_pkt_stats_info->mac_rx_total_oct_num / 4096;
+    network_pkt_stats_info->mac_tx_pfc_pkt_num = ramp(card_id, device_id, 60.0, 1000.0);
+    network_pkt_stats_info->mac_rx_pfc_pkt_num = ramp(card_id, device_id, 66.0, 1000.0);
+    network_pkt_stats_info->mac_tx_pfc_pri3_pkt_num = network_pkt_stats_info->mac_tx_pfc_pkt_num;
+    network_pkt_stats_info->mac_rx_pfc_pri3_pkt_num = network_pkt_stats_info->mac_rx_pfc_pkt_num;
+    return DCMI_OK;
+}
+
+int dcmi_get_pfc_duration_info(int card_id, int device_id, struct dcmi_pfc_duration_info *pfc_duration_info)
+{
+    if (pfc_duration_info == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_PFC_DURATION, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //单位us，只有RoCE默认的优先级3出现暂停，最多占10%的时间
+    std::memset(pfc_duration_info, 0, sizeof(*pfc_duration_info));
+    pfc_duration_info->tx[3] = ramp(card_id, device_id, 60.0, 1e5);
+    pfc_duration_info->rx[3] = ramp(card_id, device_id, 66.0, 1e5);
+    return DCMI_OK;
+}
+
+int dcmi_get_device_resource_info(int card_id, int device_id,
+    struct dcmi_proc_mem_info *proc_info, int *proc_num)
+{
+    if (proc_info == NULL || proc_num == NULL || *proc_num < 0)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_RESOURCE_INFO, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //*proc_num传入缓冲区容量；第i个进程每40秒退出一次并以新pid重启，各进程错开5秒
+    const int num = 8;
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_start).count();
+    int logic_id = card_id * DCMI_SIM_MAX_DEVICE_PER_CARD + device_id;
+    int n = std::min(num, *proc_num);
+    for (int i = 0; i < n; i++)
+    {
+        int generation = (int)((t + i * 5.0) / 40.0);
+        proc_info[i].proc_id = 10000 + logic_id * 1000 + generation * num + i;
+        proc_info[i].proc_mem_usage = (unsigned long)((i + 1) * 512.0 * 1048576.0 * (0.5 + wave(card_id, device_id, 20.0 + i)));
+    }
+    *proc_num = n;
+    return DCMI_OK;
+}
+
+int dcmi_get_device_health(int card_id, int device_id, unsigned int *health)
+{
+    if (health == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_HEALTH, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    *health = 0;
+    return DCMI_OK;
+}
+
+int dcmi_get_device_temperature(int card_id, int device_id, int *temperature)
+{
+    if (temperature == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_TEMPERATURE, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    *temperature = 40 + (int)(35.0 * wave(card_id, device_id, 90.0));
+    return DCMI_OK;
+}
+
+int dcmi_get_device_voltage(int card_id, int device_id, unsigned int *voltage)
+{
+    if (voltage == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int ret = enter_device_call(DCMI_SIM_CALL_VOLTAGE, card_id, device_id);
+    if (ret != DCMI_OK)return ret;
+    //单位0.01V
+    *voltage = 80 + (unsigned int)(10.0 * wave(card_id, device_id, 45.0));
+    return DCMI_OK;
+}
+
+int dcmi_get_card_id_device_id_from_logicid(int *card_id, int *device_id, unsigned int device_logic_id)
+{
+    if (card_id == NULL || device_id == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    int card = (int)(device_logic_id / DCMI_SIM_MAX_DEVICE_PER_CARD);
+    int device = (int)(device_logic_id % DCMI_SIM_MAX_DEVICE_PER_CARD);
+    int ret = enter_device_call(DCMI_SIM_CALL_LOGIC_ID, card, device);
+    if (ret != DCMI_OK)return ret;
+    *card_id = card;
+    *device_id = device;
+    return DCMI_OK;
+}
+
+int dcmi_subscribe_fault_event(int card_id, int device_id, struct dcmi_event_filter filter,
+    dcmi_fault_event_callback handler)
+{
+    (void)filter;
+    if (handler == NULL)return DCMI_ERR_CODE_INVALID_PARAMETER;
+    //只支持订阅全部设备
+    if (card_id != -1 || device_id != -1)return DCMI_ERR_CODE_NOT_SUPPORT;
+    int ret = enter_call(*current_config(), DCMI_SIM_CALL_SUBSCRIBE_FAULT_EVENT, -1, -1);
+    if (ret != DCMI_OK)return ret;
+    g_fault_handler.store(handler, std::memory_order_release);
+    return DCMI_OK;
+}
+
+int dcmi_sim_set_config(const struct dcmi_sim_config *config)
+{
+    if (config == NULL || !config_valid(*config))return DCMI_ERR_CODE_INVALID_PARAMETER;
+    std::lock_guard<std::mutex> lock(g_config_mutex);
+    std::atomic_store(&g_config, std::make_shared<const dcmi_sim_config>(*config));
+    return DCMI_OK;
+}
+
+void dcmi_sim_get_config(struct dcmi_sim_config *config)
+{
+    if (config == NULL)return;
+    *config = *current_config();
+}
+
+int dcmi_sim_add_fault(enum dcmi_sim_call call, int card_id, int device_id, int ret, unsigned int delay_us)
+{
+    std::lock_guard<std::mutex> lock(g_fault_mutex);
+    int n = g_fault_num.load(std::memory_order_relaxed);
+    if (n >= DCMI_SIM_MAX_FAULT_NUM)return DCMI_ERR_CODE_RESOURCE_OCCUPIED;
+    g_faults[n].call = call;
+    g_faults[n].card_id = card_id;
+    g_faults[n].device_id = device_id;
+    g_faults[n].ret = ret;
+    g_faults[n].delay_us = delay_us;
+    g_fault_num.store(n + 1, std::memory_order_release);
+    return DCMI_OK;
+}
+
+void dcmi_sim_clear_faults(void)
+{
+    std::lock_guard<std::mutex> lock(g_fault_mutex);
+    g_fault_num.store(0, std::memory_order_release);
+}
+
+int dcmi_sim_raise_fault_event(int card_id, int device_id, unsigned int event_id,
+    unsigned char severity, unsigned char assertion, const char *event_name)
+{
+    dcmi_fault_event_callback handler = g_fault_handler.load(std::memory_order_acquire);
+    if (handler == NULL)return DCMI_ERR_CODE_NOT_REDAY;
+
+    struct dcmi_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.type = DCMI_DMS_FAULT_EVENT;
+    struct dcmi_dms_fault_event& e = event.event_t.dms_event;
+    e.event_id = event_id;
+    e.deviceid = (unsigned short)(card_id * DCMI_SIM_MAX_DEVICE_PER_CARD + device_id);
+    e.severity = severity;
+    e.assertion = assertion;
+    e.event_serial_num = ++g_event_serial;
+    e.notify_serial_num = e.event_serial_num;
+    e.alarm_raised_time = (unsigned long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (event_name != NULL)std::strncpy(e.event_name, event_name, DCMI_MAX_EVENT_NAME_LENGTH - 1);
+    handler(&event);
+    return DCMI_OK;
+}
+
+unsigned long long dcmi_sim_get_call_count(void)
+{
+    return g_call_count.load(std::memory_order_relaxed);
+}
+
+} // extern "C"
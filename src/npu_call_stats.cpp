@@ -0,0 +1,53 @@
+#include "npu_call_stats.h"
+
+//10us ~ 2.5s，覆盖正常调用到驱动卡顿
+const double NPU_CALL_BUCKET_BOUNDS[NPU_CALL_BUCKET_NUM] = {
+    0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005,
+    0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+    0.1, 0.25, 0.5, 2.5
+};
+
+const char* npu_dcmi_call_name(int call)
+{
+    static const char* names[NPU_CALL_NUM] = {
+#define NPU_DCMI_CALL_NAME(id, name) name,
+        NPU_DCMI_CALL_LIST(NPU_DCMI_CALL_NAME)
+#undef NPU_DCMI_CALL_NAME
+    };
+    return call >= 0 && call < NPU_CALL_NUM ? names[call] : "unknown";
+}
+
+NPUCallStats::NPUCallStats()
+    : devices_(new NPUDeviceCallStats[NPU_MAX_DEVICE_NUM]), device_count_(0)
+{
+    for (int b = 0; b < NPU_CALL_BUCKET_NUM; b++)
+    {
+        bounds_ns_[b] = (uint64_t)(NPU_CALL_BUCKET_BOUNDS[b] * 1e9 + 0.5);
+    }
+    for (size_t i = 0; i < NPU_MAX_DEVICE_NUM; i++)reset_device(i, -1, -1);
+}
+
+void NPUCallStats::reset_device(size_t slot, int card, int device)
+{
+    if (slot >= NPU_MAX_DEVICE_NUM)return;
+    NPUDeviceCallStats& d = devices_[slot];
+    d.card_id.store(card, std::memory_order_relaxed);
+    d.device_id.store(device, std::memory_order_relaxed);
+    for (int c = 0; c < NPU_CALL_NUM; c++)
+    {
+        NPUCallHistogram& h = d.calls[c];
+        for (int b = 0; b <= NPU_CALL_BUCKET_NUM; b++)h.buckets[b].store(0, std::memory_order_relaxed);
+        h.sum_ns.store(0, std::memory_order_relaxed);
+        h.errors.store(0, std::memory_order_relaxed);
+    }
+}
+
+void NPUCallStats::set_device_count(size_t count)
+{
+    device_count_.store(count < NPU_MAX_DEVICE_NUM ? count : NPU_MAX_DEVICE_NUM, std::memory_order_release);
+}
+
+size_t NPUCallStats::device_count() const
+{
+    return device_count_.load(std::memory_order_acquire);
+}
@@ -0,0 +1,67 @@
+#include <limits>
+#include <string>
+
+#include "npu_call_stats_collectable.h"
+
+NPUCallStatsCollectable::NPUCallStatsCollectable(const NPUCallStats& stats)
+    : stats_(stats)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUCallStatsCollectable::Collect() const
+{
+    std::vector<prometheus::MetricFamily> families(2);
+    prometheus::MetricFamily& seconds = families[0];
+    seconds.name = "npu_exporter_dcmi_call_seconds";
+    seconds.help = "Latency of DCMI calls issued by the NPU exporter in seconds";
+    seconds.type = prometheus::MetricType::Histogram;
+    prometheus::MetricFamily& errors = families[1];
+    errors.name = "npu_exporter_dcmi_call_errors_total";
+    errors.help = "Number of DCMI calls issued by the NPU exporter that returned an error";
+    errors.type = prometheus::MetricType::Counter;
+
+    size_t count = stats_.device_count();
+    seconds.metric.reserve(count * NPU_CALL_NUM);
+    errors.metric.reserve(count * NPU_CALL_NUM);
+    for (size_t i = 0; i < count; i++)
+    {
+        const NPUDeviceCallStats& dev = stats_.device(i);
+        int card = dev.card_id.load(std::memory_order_relaxed);
+        if (card < 0)continue; //已移除设备回收的空槽位
+        std::string card_id = std::to_string(card);
+        std::string device_id = std::to_string(dev.device_id.load(std::memory_order_relaxed));
+        for (int c = 0; c < NPU_CALL_NUM; c++)
+        {
+            const NPUCallHistogram& h = dev.calls[c];
+            std::vector<prometheus::ClientMetric::Label> label(3);
+            label[0].name = "call";
+            label[0].value = npu_dcmi_call_name(c);
+            label[1].name = "card_id";
+            label[1].value = card_id;
+            label[2].name = "device_id";
+            label[2].value = device_id;
+
+            //桶计数为非累积存储，导出时累加
+            prometheus::ClientMetric hist;
+            hist.label = label;
+            uint64_t cumulative = 0;
+            hist.histogram.bucket.resize(NPU_CALL_BUCKET_NUM + 1);
+            for (int b = 0; b <= NPU_CALL_BUCKET_NUM; b++)
+            {
+                cumulative += h.buckets[b].load(std::memory_order_relaxed);
+                hist.histogram.bucket[b].cumulative_count = cumulative;
+                hist.histogram.bucket[b].upper_bound = b < NPU_CALL_BUCKET_NUM ?
+                    NPU_CALL_BUCKET_BOUNDS[b] : std::numeric_limits<double>::infinity();
+            }
+            hist.histogram.sample_count = cumulative;
+            hist.histogram.sample_sum = (double)h.sum_ns.load(std::memory_order_relaxed) / 1e9;
+            seconds.metric.push_back(hist);
+
+            prometheus::ClientMetric err;
+            err.label = label;
+            err.counter.value = (double)h.errors.load(std::memory_order_relaxed);
+            errors.metric.push_back(err);
+        }
+    }
+    return families;
+}
@@ -0,0 +1,206 @@
+#include "npu_columns.h"
+
+#include <cstdint>
+
+namespace {
+
+/*GCC/Clang向量扩展：128位向量直接对应x86的SSE2与aarch64的NEON，不依赖特定指令集扩展*/
+const size_t VEC_BYTES = 16;
+typedef double VecF64 __attribute__((vector_size(VEC_BYTES)));
+typedef int32_t VecI32 __attribute__((vector_size(VEC_BYTES)));
+typedef uint32_t VecU32 __attribute__((vector_size(VEC_BYTES)));
+
+static_assert(NPU_COLUMN_ALIGN % VEC_BYTES == 0, "columns must be aligned for vector loads");
+
+/*列按NPU_COLUMN_ALIGN对齐，按向量步进的每次读取都是对齐的*/
+template<typename V, typename E>
+inline void load(V& v, const E* column, size_t i)
+{
+    v = *reinterpret_cast<const V*>(column + i);
+}
+
+/*按逐元素掩码选择：mask为全1的通道取a，否则取b*/
+template<typename V, typename M>
+inline V select(M mask, V a, V b)
+{
+    return (a & (V)mask) | (b & ~(V)mask);
+}
+
+/*每次迭代处理两个向量，各用独立的累加器，避免依赖链限制吞吐*/
+double sum_f64(const double* column, size_t count)
+{
+    const size_t LANES = VEC_BYTES / sizeof(double);
+    size_t blocks = count / (2 * LANES) * (2 * LANES);
+    VecF64 acc0 = {0}, acc1 = {0}, v0, v1;
+    for (size_t i = 0; i < blocks; i += 2 * LANES)
+    {
+        load(v0, column, i);
+        load(v1, column, i + LANES);
+        acc0 += v0;
+        acc1 += v1;
+    }
+    acc0 += acc1;
+    double sum = 0;
+    for (size_t k = 0; k < LANES; k++)sum += acc0[k];
+    for (size_t i = blocks; i < count; i++)sum += column[i];
+    return sum;
+}
+
+/*各通道均为x的向量*/
+template<typename V, typename E>
+inline V splat(E x)
+{
+    V v;
+    for (size_t k = 0; k < VEC_BYTES / sizeof(E); k++)v[k] = x;
+    return v;
+}
+
+/*failed列中未置bit（该字段读取成功）的设备对应通道为全1（参与汇总），否则为0*/
+inline VecI32 valid_mask(const uint32_t* failed, size_t i, VecU32 bit)
+{
+    VecU32 f;
+    load(f, failed, i);
+    return (f & bit) == 0;
+}
+
+/*参与汇总的设备中的最大值，valid返回参与汇总的设备数*/
+int32_t max_i32(const int32_t* column, const uint32_t* failed, uint32_t bit, size_t count, size_t& valid)
+{
+    const size_t LANES = VEC_BYTES / sizeof(int32_t);
+    size_t blocks = count / (2 * LANES) * (2 * LANES);
+    int32_t result = INT32_MIN;
+    valid = 0;
+    if (blocks > 0)
+    {
+        //不参与的通道替换为最小值；掩码为-1，减去掩码即为计数
+        VecU32 bits = splat<VecU32>(bit);
+        VecI32 lowest = splat<VecI32>(INT32_MIN);
+        VecI32 acc0 = lowest, acc1 = lowest, n0 = {0}, n1 = {0}, v0, v1, m0, m1;
+        for (size_t i = 0; i < blocks; i += 2 * LANES)
+        {
+            load(v0, column, i);
+            load(v1, column, i + LANES);
+            m0 = valid_mask(failed, i, bits);
+            m1 = valid_mask(failed, i + LANES, bits);
+            v0 = select(m0, v0, lowest);
+            v1 = select(m1, v1, lowest);
+            acc0 = select(v0 > acc0, v0, acc0);
+            acc1 = select(v1 > acc1, v1, acc1);
+            n0 -= m0;
+            n1 -= m1;
+        }
+        acc0 = select(acc1 > acc0, acc1, acc0);
+        n0 += n1;
+        for (size_t k = 0; k < LANES; k++)
+        {
+            if (acc0[k] > result)result = acc0[k];
+            valid += (size_t)n0[k];
+        }
+    }
+    for (size_t i = blocks; i < count; i++)
+    {
+        if (failed[i] & bit)continue;
+        valid++;
+        if (column[i] > result)result = column[i];
+    }
+    return result;
+}
+
+/*参与汇总的设备同时求和与最小值，一次遍历，valid返回参与汇总的设备数*/
+void sum_min_u32(const uint32_t* column, const uint32_t* failed, uint32_t bit, size_t count,
+                 uint64_t& sum, uint32_t& min, size_t& valid)
+{
+    const size_t LANES = VEC_BYTES / sizeof(uint32_t);
+    size_t blocks = count / (2 * LANES) * (2 * LANES);
+    sum = 0;
+    min = UINT32_MAX;
+    valid = 0;
+    if (blocks > 0)
+    {
+        //利用率不超过100，每通道至多累加NPU_MAX_DEVICE_NUM/LANES个值，32位不会溢出
+        //不参与的通道求和按0、求最小值按最大值处理
+        VecU32 bits = splat<VecU32>(bit);
+        VecU32 highest = splat<VecU32>(UINT32_MAX);
+        VecU32 acc0 = {0}, acc1 = {0}, low0 = highest, low1 = highest, v0, v1;
+        VecI32 n0 = {0}, n1 = {0}, m0, m1;
+        for (size_t i = 0; i < blocks; i += 2 * LANES)
+        {
+            load(v0, column, i);
+            load(v1, column, i + LANES);
+            m0 = valid_mask(failed, i, bits);
+            m1 = valid_mask(failed, i + LANES, bits);
+            acc0 += v0 & (VecU32)m0;
+            acc1 += v1 & (VecU32)m1;
+            v0 = select(m0, v0, highest);
+            v1 = select(m1, v1, highest);
+            low0 = select(v0 < low0, v0, low0);
+            low1 = select(v1 < low1, v1, low1);
+            n0 -= m0;
+            n1 -= m1;
+        }
+        acc0 += acc1;
+        low0 = select(low1 < low0, low1, low0);
+        n0 += n1;
+        for (size_t k = 0; k < LANES; k++)
+        {
+            sum += acc0[k];
+            if (low0[k] < min)min = low0[k];
+            valid += (size_t)n0[k];
+        }
+    }
+    for (size_t i = blocks; i < count; i++)
+    {
+        if (failed[i] & bit)continue;
+        valid++;
+        sum += column[i];
+        if (column[i] < min)min = column[i];
+    }
+}
+
+/*failed列非0的设备数*/
+size_t count_failed(const uint32_t* failed, size_t count)
+{
+    const size_t LANES = VEC_BYTES / sizeof(uint32_t);
+    size_t blocks = count / LANES * LANES;
+    size_t result = 0;
+    VecI32 n = {0};
+    VecU32 v;
+    for (size_t i = 0; i < blocks; i += LANES)
+    {
+        load(v, failed, i);
+        n -= v != 0;
+    }
+    for (size_t k = 0; k < LANES; k++)result += (size_t)n[k];
+    for (size_t i = blocks; i < count; i++)if (failed[i] != 0)result++;
+    return result;
+}
+
+} // namespace
+
+void npu_node_aggregate(const NPUColumns& columns, NPUNodeAggregate& out)
+{
+    size_t count = columns.count > NPU_MAX_DEVICE_NUM ? NPU_MAX_DEVICE_NUM : columns.count;
+    out.devices = count;
+    out.devices_failed = 0;
+    out.power_sum = 0;
+    out.temperature_devices = 0;
+    out.temperature_max = 0;
+    out.util_aicore_devices = 0;
+    out.util_aicore_mean = 0;
+    out.util_aicore_min = 0;
+    if (count == 0)return;
+
+    out.devices_failed = count_failed(columns.failed, count);
+    //功耗读取失败时上报为0，直接求和即等同于排除失败设备
+    out.power_sum = sum_f64(columns.power, count);
+    int32_t temperature_max = max_i32(columns.temperature, columns.failed, NPU_METRIC_BIT(temperature),
+                                      count, out.temperature_devices);
+    if (out.temperature_devices > 0)out.temperature_max = temperature_max;
+    uint64_t util_sum = 0;
+    uint32_t util_min = 0;
+    sum_min_u32(columns.util_aicore, columns.failed, NPU_METRIC_BIT(util_aicore), count,
+                util_sum, util_min, out.util_aicore_devices);
+    if (out.util_aicore_devices == 0)return;
+    out.util_aicore_min = util_min;
+    out.util_aicore_mean = (double)util_sum / out.util_aicore_devices;
+}
@@ -0,0 +1,161 @@
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <zlib.h>
+
+#include <prometheus/metric_family.h>
+#include <prometheus/text_serializer.h>
+
+#include "npu_exposition_cache.h"
+
+namespace {
+
+/*gzip压缩（windowBits=15+16输出gzip头），失败返回false*/
+bool gzip_compress(const std::string& in, std::string& out)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)return false;
+
+    out.resize(deflateBound(&zs, (uLong)in.size()));
+    zs.next_in = (Bytef*)in.data();
+    zs.avail_in = (uInt)in.size();
+    zs.next_out = (Bytef*)&out[0];
+    zs.avail_out = (uInt)out.size();
+    int ret = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return ret == Z_STREAM_END;
+}
+
+/*去掉首尾空白（空格与制表符）*/
+std::string trim(const std::string& s, size_t begin, size_t end)
+{
+    while (begin < end && (s[begin] == ' ' || s[begin] == '\t'))begin++;
+    while (end > begin && (s[end - 1] == ' ' || s[end - 1] == '\t'))end--;
+    return s.substr(begin, end - begin);
+}
+
+/*解析Accept-Encoding中的一项（如"gzip;q=0.5"），得到小写的编码名与q值（缺省为1，无法解析时按0即拒绝）*/
+void parse_coding(const std::string& item, std::string& coding, double& q)
+{
+    size_t semi = item.find(';');
+    coding = trim(item, 0, semi == std::string::npos ? item.size() : semi);
+    for (size_t i = 0; i < coding.size(); i++)coding[i] = (char)std::tolower((unsigned char)coding[i]);
+    q = 1.0;
+    while (semi != std::string::npos)
+    {
+        size_t next = item.find(';', semi + 1);
+        std::string param = trim(item, semi + 1, next == std::string::npos ? item.size() : next);
+        if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+        {
+            char* end = nullptr;
+            q = std::strtod(param.c_str() + 2, &end);
+            if (end == param.c_str() + 2 || *end != '\0' || !(q >= 0.0))q = 0.0;
+        }
+        semi = next;
+    }
+}
+
+/*客户端是否接受gzip：逗号分隔的编码列表，按q值判断；显式的gzip项优先于"*"，q=0表示拒绝*/
+bool accepts_gzip(const std::string& accept_encoding)
+{
+    bool has_gzip = false, has_any = false;
+    double gzip_q = 0.0, any_q = 0.0;
+    size_t pos = 0;
+    while (pos <= accept_encoding.size())
+    {
+        size_t end = accept_encoding.find(',', pos);
+        if (end == std::string::npos)end = accept_encoding.size();
+        std::string coding;
+        double q = 0.0;
+        parse_coding(accept_encoding.substr(pos, end - pos), coding, q);
+        if (coding == "gzip" || coding == "x-gzip")
+        {
+            has_gzip = true;
+            gzip_q = q;
+        }
+        else if (coding == "*")
+        {
+            has_any = true;
+            any_q = q;
+        }
+        pos = end + 1;
+    }
+    if (has_gzip)return gzip_q > 0.0;
+    return has_any && any_q > 0.0;
+}
+
+} // namespace
+
+NPUExpositionCache::NPUExpositionCache(bool gzip)
+    : gzip_(gzip), renders_(0)
+{
+}
+
+void NPUExpositionCache::add_collectable(const std::weak_ptr<prometheus::Collectable>& collectable)
+{
+    std::lock_guard<std::mutex> lock(render_mutex_);
+    collectables_.push_back(collectable);
+}
+
+void NPUExpositionCache::render(uint64_t cycle)
+{
+    std::lock_guard<std::mutex> lock(render_mutex_);
+
+    std::vector<prometheus::MetricFamily> families;
+    for (const auto& weak : collectables_)
+    {
+        auto collectable = weak.lock();
+        if (!collectable)continue;
+        auto collected = collectable->Collect();
+        families.insert(families.end(),
+            std::make_move_iterator(collected.begin()), std::make_move_iterator(collected.end()));
+    }
+
+    std::ostringstream out;
+    prometheus::TextSerializer().Serialize(out, families);
+
+    std::shared_ptr<NPUExposition> exposition = std::make_shared<NPUExposition>();
+    exposition->generation = ++renders_;
+    exposition->cycle = cycle;
+    exposition->body = out.str();
+    if (gzip_ && !gzip_compress(exposition->body, exposition->gzip_body))exposition->gzip_body.clear();
+    std::atomic_store(&current_, std::shared_ptr<const NPUExposition>(exposition));
+}
+
+std::shared_ptr<const NPUExposition> NPUExpositionCache::current() const
+{
+    return std::atomic_load(&current_);
+}
+
+void NPUExpositionCache::serve(NPUHttpServer& server, const std::string& path)
+{
+    server.handle(path, [this](const NPUHttpRequest& req, NPUHttpResponse& resp) {
+        std::shared_ptr<const NPUExposition> exposition = current();
+        if (!exposition)
+        {
+            resp.status = 503;
+            resp.body = "no sample cycle rendered yet\n";
+            return;
+        }
+        resp.content_type = "text/plain; version=0.0.4; charset=utf-8";
+        resp.headers.push_back(std::make_pair("X-NPU-Generation", std::to_string(exposition->generation)));
+        resp.headers.push_back(std::make_pair("X-NPU-Cycle", std::to_string(exposition->cycle)));
+        resp.headers.push_back(std::make_pair("Vary", "Accept-Encoding"));
+        if (!exposition->gzip_body.empty() && accepts_gzip(req.header("accept-encoding")))
+        {
+            resp.content_encoding = "gzip";
+            resp.data = exposition->gzip_body.data();
+            resp.size = exposition->gzip_body.size();
+        }
+        else
+        {
+            resp.data = exposition->body.data();
+            resp.size = exposition->body.size();
+        }
+        resp.hold = exposition;
+    });
+}
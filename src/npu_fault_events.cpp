@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstring>
+
+#include "npu_fault_events.h"
+#include "npu_logger.h"
+#include "dcmi_interface_api.h"
+
+#define NPU_OK (0)
+
+namespace {
+
+const size_t EVENT_QUEUE_CAPACITY = 1024;           //待处理事件上限
+const std::chrono::milliseconds POLL_INTERVAL(5);   //后台线程轮询间隔（决定检测延迟）
+const std::chrono::milliseconds NOTIFY_INTERVAL(100); //两次通知监听者的最小间隔（事件风暴时合并）
+
+uint64_t unix_ms()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+NPUFaultEvents& NPUFaultEvents::instance()
+{
+    static NPUFaultEvents events;
+    return events;
+}
+
+NPUFaultEvents::NPUFaultEvents()
+    : queue_(EVENT_QUEUE_CAPACITY), dropped_(0), subscribed_(false), received_(0), stopping_(false)
+{
+    std::memset(recent_, 0, sizeof(recent_));
+    thread_ = std::thread(&NPUFaultEvents::run, this);
+}
+
+NPUFaultEvents::~NPUFaultEvents()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+bool NPUFaultEvents::subscribe()
+{
+    if (subscribed_.load(std::memory_order_acquire))return true;
+    struct dcmi_event_filter filter;
+    std::memset(&filter, 0, sizeof(filter)); //filter_flag为0：不过滤
+    int ret = dcmi_subscribe_fault_event(-1, -1, filter, &NPUFaultEvents::on_event);
+    if (ret != NPU_OK)
+    {
+        NPULogger::instance().log("dcmi_subscribe_fault_event failed", ret, -1, -1, false);
+        return false;
+    }
+    subscribed_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool NPUFaultEvents::subscribed() const
+{
+    return subscribed_.load(std::memory_order_acquire);
+}
+
+void NPUFaultEvents::set_listener(const std::function<void(const NPUFaultEvent&)>& listener)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = listener;
+}
+
+NPUFaultSnapshot NPUFaultEvents::snapshot() const
+{
+    NPUFaultSnapshot snap;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& kv : counts_)
+    {
+        NPUFaultCount c = {kv.first.first.first, kv.first.first.second, kv.first.second, kv.second};
+        snap.counts.push_back(c);
+    }
+    for (const auto& kv : active_)
+    {
+        NPUFaultActive a = {kv.first.first, kv.first.second, (uint64_t)kv.second.size()};
+        snap.active.push_back(a);
+    }
+    uint64_t n = received_ < NPU_FAULT_RECENT_NUM ? received_ : NPU_FAULT_RECENT_NUM;
+    for (uint64_t i = received_ - n; i < received_; i++)snap.recent.push_back(recent_[i % NPU_FAULT_RECENT_NUM]);
+    snap.received = received_;
+    snap.dropped = dropped_.load(std::memory_order_relaxed);
+    return snap;
+}
+
+void NPUFaultEvents::on_event(struct dcmi_event* event)
+{
+    if (event == NULL || event->type != DCMI_DMS_FAULT_EVENT)return;
+    const struct dcmi_dms_fault_event& e = event->event_t.dms_event;
+
+    NPUFaultEvent item;
+    item.logic_id = e.deviceid;
+    item.card_id = -1;
+    item.device_id = -1;
+    item.event_id = e.event_id;
+    item.severity = e.severity;
+    item.assertion = e.assertion;
+    item.serial = e.event_serial_num;
+    item.raised_ms = e.alarm_raised_time;
+    item.received_ms = unix_ms();
+    std::strncpy(item.name, e.event_name, NPU_FAULT_NAME_LEN - 1);
+    item.name[NPU_FAULT_NAME_LEN - 1] = '\0';
+
+    NPUFaultEvents& self = instance();
+    if (!self.queue_.push(item))self.dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NPUFaultEvents::run()
+{
+    //监听者（如重新渲染）开销远大于记录一个事件：每批取空队列后最多通知一次，
+    //且两次通知至少间隔NOTIFY_INTERVAL，期间到达的事件合并到下一次通知
+    bool pending = false;
+    NPUFaultEvent latest;
+    std::chrono::steady_clock::time_point last_notify = std::chrono::steady_clock::now() - NOTIFY_INTERVAL;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        lock.unlock();
+        NPUFaultEvent event;
+        while (queue_.pop(event))
+        {
+            //事件很少，逐个向驱动查询逻辑ID对应的卡与设备（设备热插拔后映射可能变化，不缓存）
+            int card = -1, device = -1;
+            if (dcmi_get_card_id_device_id_from_logicid(&card, &device, event.logic_id) == NPU_OK)
+            {
+                event.card_id = card;
+                event.device_id = device;
+            }
+            {
+                std::lock_guard<std::mutex> apply_lock(mutex_);
+                apply(event);
+            }
+            latest = event;
+            pending = true;
+        }
+
+        if (pending)
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (now - last_notify >= NOTIFY_INTERVAL)
+            {
+                std::function<void(const NPUFaultEvent&)> listener;
+                {
+                    std::lock_guard<std::mutex> listener_lock(mutex_);
+                    listener = listener_;
+                }
+                if (listener)listener(latest);
+                pending = false;
+                last_notify = now;
+            }
+        }
+        lock.lock();
+        cv_.wait_for(lock, POLL_INTERVAL, [this] { return stopping_; });
+    }
+}
+
+void NPUFaultEvents::apply(const NPUFaultEvent& event)
+{
+    std::pair<int, int> device(event.card_id, event.device_id);
+    counts_[std::make_pair(device, (unsigned int)event.severity)]++;
+    if (event.assertion == 1)active_[device].insert(event.event_id);
+    else if (event.assertion == 0)
+    {
+        auto it = active_.find(device);
+        if (it != active_.end())
+        {
+            it->second.erase(event.event_id);
+            if (it->second.empty())active_.erase(it);
+        }
+    }
+    recent_[received_ % NPU_FAULT_RECENT_NUM] = event;
+    received_++;
+}
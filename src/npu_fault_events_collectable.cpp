@@ -0,0 +1,99 @@
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "npu_fault_events_collectable.h"
+
+namespace {
+
+/*card_id/device_id标签*/
+std::vector<prometheus::ClientMetric::Label> device_labels(int card_id, int device_id)
+{
+    std::vector<prometheus::ClientMetric::Label> label(2);
+    label[0].name = "card_id";
+    label[0].value = std::to_string(card_id);
+    label[1].name = "device_id";
+    label[1].value = std::to_string(device_id);
+    return label;
+}
+
+void add_label(std::vector<prometheus::ClientMetric::Label>& label, const char* name, const std::string& value)
+{
+    prometheus::ClientMetric::Label l;
+    l.name = name;
+    l.value = value;
+    label.push_back(l);
+}
+
+} // namespace
+
+NPUFaultEventsCollectable::NPUFaultEventsCollectable(const NPUFaultEvents& events)
+    : events_(events)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUFaultEventsCollectable::Collect() const
+{
+    NPUFaultSnapshot snap = events_.snapshot();
+
+    std::vector<prometheus::MetricFamily> families(4);
+    prometheus::MetricFamily& total = families[0];
+    total.name = "npu_fault_events_total";
+    total.help = "Number of NPU fault events reported by the driver";
+    total.type = prometheus::MetricType::Counter;
+    for (const NPUFaultCount& c : snap.counts)
+    {
+        prometheus::ClientMetric m;
+        m.label = device_labels(c.card_id, c.device_id);
+        add_label(m.label, "severity", std::to_string(c.severity));
+        m.counter.value = (double)c.count;
+        total.metric.push_back(m);
+    }
+
+    prometheus::MetricFamily& active = families[1];
+    active.name = "npu_fault_active";
+    active.help = "Number of NPU faults raised and not yet recovered";
+    active.type = prometheus::MetricType::Gauge;
+    for (const NPUFaultActive& a : snap.active)
+    {
+        prometheus::ClientMetric m;
+        m.label = device_labels(a.card_id, a.device_id);
+        m.gauge.value = (double)a.count;
+        active.metric.push_back(m);
+    }
+
+    prometheus::MetricFamily& recent = families[2];
+    recent.name = "npu_fault_event_timestamp_seconds";
+    recent.help = "Time at which the latest of the most recent NPU fault events with these labels was received";
+    recent.type = prometheus::MetricType::Gauge;
+    //标签不含事件序号，序列只随事件种类变化；同一种事件重复上报时更新为最新的到达时刻
+    std::map<std::tuple<int, int, unsigned int, int, int>, size_t> seen;
+    for (const NPUFaultEvent& e : snap.recent)
+    {
+        auto key = std::make_tuple(e.card_id, e.device_id, e.event_id, (int)e.severity, (int)e.assertion);
+        auto it = seen.find(key);
+        if (it != seen.end())
+        {
+            recent.metric[it->second].gauge.value = (double)e.received_ms / 1000.0;
+            continue;
+        }
+        seen[key] = recent.metric.size();
+        prometheus::ClientMetric m;
+        m.label = device_labels(e.card_id, e.device_id);
+        add_label(m.label, "event_id", std::to_string(e.event_id));
+        add_label(m.label, "event_name", e.name);
+        add_label(m.label, "severity", std::to_string(e.severity));
+        add_label(m.label, "assertion", std::to_string(e.assertion));
+        m.gauge.value = (double)e.received_ms / 1000.0;
+        recent.metric.push_back(m);
+    }
+
+    prometheus::MetricFamily& dropped = families[3];
+    dropped.name = "npu_exporter_fault_events_dropped_total";
+    dropped.help = "Number of NPU fault events dropped because the event queue was full";
+    dropped.type = prometheus::MetricType::Counter;
+    prometheus::ClientMetric m;
+    m.counter.value = (double)snap.dropped;
+    dropped.metric.push_back(m);
+    return families;
+}
@@ -0,0 +1,82 @@
+#include <string>
+
+#include "npu_hccs_collectable.h"
+
+namespace {
+
+/*各导出项*/
+enum HccsFamily
+{
+    HCCS_TX,
+    HCCS_RX,
+    HCCS_TOTAL_TX,
+    HCCS_TOTAL_RX,
+    HCCS_TIMESTAMP,
+    HCCS_FAMILY_NUM
+};
+
+const struct
+{
+    const char* name;
+    const char* help;
+} HCCS_FAMILIES[HCCS_FAMILY_NUM] = {
+    {"npu_hccs_tx_bandwidth_megabytes_per_second", "NPU HCCS transmit bandwidth per PCS over the last profiling window in MB/s"},
+    {"npu_hccs_rx_bandwidth_megabytes_per_second", "NPU HCCS receive bandwidth per PCS over the last profiling window in MB/s"},
+    {"npu_hccs_total_tx_bandwidth_megabytes_per_second", "NPU HCCS total transmit bandwidth over the last profiling window in MB/s"},
+    {"npu_hccs_total_rx_bandwidth_megabytes_per_second", "NPU HCCS total receive bandwidth over the last profiling window in MB/s"},
+    {"npu_hccs_window_timestamp_seconds", "End of the last successful NPU HCCS profiling window as a Unix timestamp"},
+};
+
+void add_gauge(prometheus::MetricFamily& family, const std::vector<prometheus::ClientMetric::Label>& label, double value)
+{
+    prometheus::ClientMetric m;
+    m.label = label;
+    m.gauge.value = value;
+    family.metric.push_back(m);
+}
+
+} // namespace
+
+NPUHccsCollectable::NPUHccsCollectable(const NPUHccsProfiler& profiler)
+    : profiler_(profiler)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUHccsCollectable::Collect() const
+{
+    std::vector<NPUHccsBandwidth> bandwidth;
+    profiler_.snapshot(bandwidth);
+
+    std::vector<prometheus::MetricFamily> families(HCCS_FAMILY_NUM);
+    for (int f = 0; f < HCCS_FAMILY_NUM; f++)
+    {
+        families[f].name = HCCS_FAMILIES[f].name;
+        families[f].help = HCCS_FAMILIES[f].help;
+        families[f].type = prometheus::MetricType::Gauge;
+    }
+
+    for (const NPUHccsBandwidth& b : bandwidth)
+    {
+        if (b.timestamp_ms == 0)continue;
+        std::vector<prometheus::ClientMetric::Label> label(2);
+        label[0].name = "card_id";
+        label[0].value = std::to_string(b.card_id);
+        label[1].name = "device_id";
+        label[1].value = std::to_string(b.device_id);
+        add_gauge(families[HCCS_TIMESTAMP], label, (double)b.timestamp_ms / 1000.0);
+        if (!b.valid)continue;
+
+        add_gauge(families[HCCS_TOTAL_TX], label, b.total_tx);
+        add_gauge(families[HCCS_TOTAL_RX], label, b.total_rx);
+        label.resize(3);
+        label[2].name = "pcs";
+        for (int p = 0; p < NPU_HCCS_PCS_NUM; p++)
+        {
+            if (!(b.pcs_mask & (1u << p)))continue;
+            label[2].value = std::to_string(p);
+            add_gauge(families[HCCS_TX], label, b.tx[p]);
+            add_gauge(families[HCCS_RX], label, b.rx[p]);
+        }
+    }
+    return families;
+}
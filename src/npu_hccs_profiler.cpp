@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "npu_hccs_profiler.h"
+#include "npu_logger.h"
+#include "dcmi_interface_api.h"
+
+#define NPU_OK (0)
+
+static_assert(NPU_HCCS_PCS_NUM == DCMI_HCCS_MAX_PCS_NUM, "PCS count must match the DCMI header");
+
+NPUHccsProfiler::NPUHccsProfiler(std::chrono::milliseconds window, std::chrono::milliseconds interval)
+    : window_(window), interval_(std::max(interval, window)), windows_(0), pending_(false),
+      job_window_(0), window_seq_(0), running_(false)
+{
+    task_ = [this](size_t index) { measure(index); };
+}
+
+NPUHccsProfiler::~NPUHccsProfiler()
+{
+    stop();
+}
+
+void NPUHccsProfiler::set_devices(const std::vector<NPULabel>& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_labels_ = labels;
+    pending_ = true;
+}
+
+void NPUHccsProfiler::start()
+{
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    if (running_)return;
+    running_ = true;
+    thread_ = std::thread(&NPUHccsProfiler::run, this);
+}
+
+void NPUHccsProfiler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (!running_)return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())thread_.join();
+}
+
+std::chrono::milliseconds NPUHccsProfiler::window() const
+{
+    return window_;
+}
+
+uint64_t NPUHccsProfiler::snapshot(std::vector<NPUHccsBandwidth>& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out = published_;
+    return windows_;
+}
+
+size_t NPUHccsProfiler::apply_devices()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    //工作线程仍在测量（上个窗口超时）时不能改动工作区，下个窗口再切换
+    if (!pending_ || (pool_ && !pool_->idle()))return work_.size();
+
+    std::map<std::pair<int, int>, NPUHccsBandwidth> old;
+    for (const NPUHccsBandwidth& b : published_)old[std::make_pair(b.card_id, b.device_id)] = b;
+
+    size_t n = pending_labels_.size();
+    published_.assign(n, NPUHccsBandwidth());
+    for (size_t i = 0; i < n; i++)
+    {
+        auto it = old.find(std::make_pair(pending_labels_[i].card_id, pending_labels_[i].device_id));
+        if (it != old.end())published_[i] = it->second;
+        published_[i].card_id = pending_labels_[i].card_id;
+        published_[i].device_id = pending_labels_[i].device_id;
+    }
+    work_ = published_;
+    done_.reset(new std::atomic<uint64_t>[n]);
+    for (size_t i = 0; i < n; i++)done_[i].store(0);
+    //每设备一个工作线程，全部设备的窗口同时进行
+    if (n == 0)pool_.reset();
+    else if (!pool_ || pool_->size() != n)pool_.reset(new NPUWorkerPool(n));
+    pending_ = false;
+    return n;
+}
+
+void NPUHccsProfiler::measure(size_t index)
+{
+    uint64_t window = job_window_.load(std::memory_order_acquire);
+    NPUHccsBandwidth& b = work_[index];
+
+    struct dcmi_hccs_bandwidth_info info;
+    std::memset(&info, 0, sizeof(info));
+    info.profiling_time = (int)window_.count();
+    int ret = dcmi_get_hccs_link_bandwidth_info(b.card_id, b.device_id, &info);
+    if (ret != NPU_OK)
+    {
+        NPULogger::instance().log("get HCCS link bandwidth failed", ret, b.card_id, b.device_id, false);
+        return;
+    }
+    b.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    b.total_tx = info.total_txbw;
+    b.total_rx = info.total_rxbw;
+    for (int p = 0; p < NPU_HCCS_PCS_NUM; p++)
+    {
+        b.tx[p] = info.tx_bandwidth[p];
+        b.rx[p] = info.rx_bandwidth[p];
+    }
+    done_[index].store(window, std::memory_order_release);
+}
+
+void NPUHccsProfiler::profile_once()
+{
+    size_t n = apply_devices();
+    if (n == 0)return;
+
+    uint64_t window = ++window_seq_;
+    job_window_.store(window, std::memory_order_release);
+    //驱动在窗口结束后返回；超过窗口长度加宽限（至少1秒）仍未返回的设备本窗口记为失败
+    auto grace = std::max<std::chrono::steady_clock::duration>(window_, std::chrono::seconds(1));
+    pool_->run_until(task_, std::chrono::steady_clock::now() + window_ + grace);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < n; i++)
+    {
+        NPUHccsBandwidth& b = published_[i];
+        if (done_[i].load(std::memory_order_acquire) != window)
+        {
+            b.valid = false;
+            continue;
+        }
+        uint32_t mask = b.pcs_mask;
+        b = work_[i];
+        for (int p = 0; p < NPU_HCCS_PCS_NUM; p++)
+        {
+            if (b.tx[p] != 0 || b.rx[p] != 0)mask |= 1u << p;
+        }
+        b.pcs_mask = mask;
+        b.valid = true;
+    }
+    windows_++;
+}
+
+void NPUHccsProfiler::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    while (running_)
+    {
+        lock.unlock();
+        profile_once();
+        lock.lock();
+
+        next += interval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now)next = now;
+        cv_.wait_until(lock, next, [this] { return !running_; });
+    }
+}
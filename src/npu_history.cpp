@@ -0,0 +1,351 @@
+#include <cstring>
+#include <type_traits>
+
+#include "npu_history.h"
+
+namespace {
+
+const uint32_t BLOCK_BITS = sizeof(((NPUHistoryBlock*)0)->words) * 8;
+/*单个样本编码的最大位数：时间戳与整型字段最多4+64位，double字段最多2+5+6+64位*/
+const uint32_t MAX_SAMPLE_BITS = 68 + NPU_METRIC_NUM * 77;
+
+/*位流写入（低位在前）*/
+void put_bits(NPUHistoryBlock& b, uint64_t v, unsigned n)
+{
+    if (n == 0)return;
+    if (n < 64)v &= (1ULL << n) - 1;
+    size_t w = b.bits >> 6;
+    unsigned off = b.bits & 63;
+    b.words[w] |= v << off;
+    if (off + n > 64)b.words[w + 1] |= v >> (64 - off);
+    b.bits += n;
+}
+
+/*位流读取*/
+uint64_t get_bits(const NPUHistoryBlock& b, uint32_t& pos, unsigned n)
+{
+    if (n == 0)return 0;
+    size_t w = pos >> 6;
+    unsigned off = pos & 63;
+    uint64_t v = b.words[w] >> off;
+    if (off + n > 64)v |= b.words[w + 1] << (64 - off);
+    pos += n;
+    if (n < 64)v &= (1ULL << n) - 1;
+    return v;
+}
+
+uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+int64_t unzigzag(uint64_t z)
+{
+    return (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+}
+
+/*分档变长整数：0 -> '0'，<2^7 -> '10'+7位，<2^12 -> '110'+12位，<2^20 -> '1110'+20位，否则'1111'+64位*/
+const unsigned BUCKET_BITS[4] = {7, 12, 20, 64};
+
+void put_varint(NPUHistoryBlock& b, uint64_t z)
+{
+    if (z == 0)
+    {
+        put_bits(b, 0, 1);
+        return;
+    }
+    for (unsigned i = 0; i < 4; i++)
+    {
+        if (i < 3 && z >= (1ULL << BUCKET_BITS[i]))continue;
+        //i个前导1，i<3时以0结束
+        put_bits(b, (1ULL << (i + 1)) - 1, i + 1);
+        if (i < 3)put_bits(b, 0, 1);
+        put_bits(b, z, BUCKET_BITS[i]);
+        return;
+    }
+}
+
+uint64_t get_varint(const NPUHistoryBlock& b, uint32_t& pos)
+{
+    if (get_bits(b, pos, 1) == 0)return 0;
+    unsigned i = 0;
+    while (i < 3 && get_bits(b, pos, 1) == 1)i++;
+    return get_bits(b, pos, BUCKET_BITS[i]);
+}
+
+unsigned leading_zeros(uint64_t v)
+{
+    return v ? (unsigned)__builtin_clzll(v) : 64;
+}
+
+unsigned trailing_zeros(uint64_t v)
+{
+    return v ? (unsigned)__builtin_ctzll(v) : 64;
+}
+
+/*字段值与64位表示互转*/
+uint64_t to_bits(double v)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+uint64_t to_bits(uint32_t v) { return v; }
+uint64_t to_bits(uint64_t v) { return v; }
+uint64_t to_bits(int32_t v) { return (uint64_t)(int64_t)v; }
+
+void from_bits(uint64_t bits, double& v) { std::memcpy(&v, &bits, sizeof(v)); }
+void from_bits(uint64_t bits, uint32_t& v) { v = (uint32_t)bits; }
+void from_bits(uint64_t bits, uint64_t& v) { v = bits; }
+void from_bits(uint64_t bits, int32_t& v) { v = (int32_t)(int64_t)bits; }
+
+/*double字段：Gorilla XOR编码。'0'相同；'10'沿用上次的有效位窗口；'11'+5位前导零+6位有效位长+有效位*/
+void put_xor(NPUHistoryBlock& b, uint64_t bits, uint64_t& prev, uint8_t& leading, uint8_t& trailing)
+{
+    uint64_t x = bits ^ prev;
+    prev = bits;
+    if (x == 0)
+    {
+        put_bits(b, 0, 1);
+        return;
+    }
+    unsigned lz = leading_zeros(x);
+    unsigned tz = trailing_zeros(x);
+    if (lz > 31)lz = 31;
+    if (leading != 0xFF && lz >= leading && tz >= trailing)
+    {
+        put_bits(b, 1, 2); //'10'（低位在前：先1后0）
+        put_bits(b, x >> trailing, 64 - leading - trailing);
+        return;
+    }
+    unsigned meaningful = 64 - lz - tz;
+    put_bits(b, 3, 2);
+    put_bits(b, lz, 5);
+    put_bits(b, meaningful & 63, 6); //64记为0
+    put_bits(b, x >> tz, meaningful);
+    leading = (uint8_t)lz;
+    trailing = (uint8_t)tz;
+}
+
+uint64_t get_xor(const NPUHistoryBlock& b, uint32_t& pos, uint64_t& prev, uint8_t& leading, uint8_t& trailing)
+{
+    if (get_bits(b, pos, 1) == 0)return prev;
+    if (get_bits(b, pos, 1) == 1)
+    {
+        leading = (uint8_t)get_bits(b, pos, 5);
+        unsigned meaningful = (unsigned)get_bits(b, pos, 6);
+        if (meaningful == 0)meaningful = 64;
+        trailing = (uint8_t)(64 - leading - meaningful);
+    }
+    unsigned meaningful = 64 - leading - trailing;
+    prev ^= get_bits(b, pos, meaningful) << trailing;
+    return prev;
+}
+
+/*按字段类型选择编码方式*/
+template<typename V>
+void put_field(NPUHistoryBlock& b, V v, uint64_t& prev, uint8_t& leading, uint8_t& trailing)
+{
+    if (std::is_floating_point<V>::value)
+    {
+        put_xor(b, to_bits(v), prev, leading, trailing);
+        return;
+    }
+    uint64_t bits = to_bits(v);
+    put_varint(b, zigzag((int64_t)(bits - prev)));
+    prev = bits;
+}
+
+template<typename V>
+void get_field(const NPUHistoryBlock& b, uint32_t& pos, V& v, uint64_t& prev, uint8_t& leading, uint8_t& trailing)
+{
+    if (std::is_floating_point<V>::value)
+    {
+        from_bits(get_xor(b, pos, prev, leading, trailing), v);
+        return;
+    }
+    prev += (uint64_t)unzigzag(get_varint(b, pos));
+    from_bits(prev, v);
+}
+
+} // namespace
+
+void NPUHistory::Codec::reset(int64_t first_ms)
+{
+    prev_ms = first_ms;
+    prev_delta = 0;
+    for (int k = 0; k < NPU_METRIC_NUM; k++)
+    {
+        prev[k] = 0;
+        leading[k] = 0xFF;
+        trailing[k] = 0;
+    }
+}
+
+NPUHistory::NPUHistory(size_t bytes_per_device)
+    : block_num_(bytes_per_device / sizeof(NPUHistoryBlock))
+{
+    if (block_num_ < 2)block_num_ = 2;
+}
+
+void NPUHistory::append(int64_t timestamp_ms, const std::vector<NPULabel>& labels, const std::vector<NPUMetric>& metrics)
+{
+    size_t n = labels.size() < metrics.size() ? labels.size() : metrics.size();
+
+    //设备集变化时重建下标到设备的缓存（只在此时可能分配内存）
+    bool same = n == cached_labels_.size();
+    for (size_t i = 0; same && i < n; i++)
+    {
+        same = labels[i].card_id == cached_labels_[i].card_id && labels[i].device_id == cached_labels_[i].device_id;
+    }
+    if (!same)
+    {
+        std::lock_guard<std::mutex> lock(map_mutex_);
+        cached_labels_.assign(labels.begin(), labels.begin() + n);
+        cached_devices_.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            std::unique_ptr<Device>& d = devices_[std::make_pair(labels[i].card_id, labels[i].device_id)];
+            if (!d)
+            {
+                d.reset(new Device());
+                d->label = labels[i];
+                d->blocks.reset(new NPUHistoryBlock[block_num_]);
+                d->head = 0;
+                d->used = 0;
+                d->next_seq = 1;
+            }
+            cached_devices_[i] = d.get();
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        Device& d = *cached_devices_[i];
+        std::lock_guard<std::mutex> lock(d.mutex);
+        append_sample(d, timestamp_ms, metrics[i]);
+    }
+}
+
+void NPUHistory::append_sample(Device& d, int64_t timestamp_ms, const NPUMetric& m)
+{
+    //当前块放不下最坏情况的样本时换到下一块（覆盖最旧的块）
+    if (d.used == 0 || d.blocks[d.head].bits + MAX_SAMPLE_BITS > BLOCK_BITS)
+    {
+        if (d.used > 0)d.head = (d.head + 1) % block_num_;
+        if (d.used < block_num_)d.used++;
+        NPUHistoryBlock& fresh = d.blocks[d.head];
+        std::memset(&fresh, 0, sizeof(fresh));
+        fresh.first_ms = timestamp_ms;
+        fresh.min_ms = timestamp_ms;
+        fresh.max_ms = timestamp_ms;
+        fresh.seq = d.next_seq++;
+        d.codec.reset(timestamp_ms);
+    }
+    NPUHistoryBlock& b = d.blocks[d.head];
+    Codec& c = d.codec;
+
+    //时间戳：二阶差分
+    int64_t delta = timestamp_ms - c.prev_ms;
+    put_varint(b, zigzag(delta - c.prev_delta));
+    c.prev_delta = delta;
+    c.prev_ms = timestamp_ms;
+
+#define NPU_HISTORY_PUT(field, name, help) \
+    put_field(b, m.field, c.prev[NPU_METRIC_##field], c.leading[NPU_METRIC_##field], c.trailing[NPU_METRIC_##field]);
+    NPU_METRIC_LIST(NPU_HISTORY_PUT)
+#undef NPU_HISTORY_PUT
+
+    if (timestamp_ms < b.min_ms)b.min_ms = timestamp_ms;
+    if (timestamp_ms > b.max_ms)b.max_ms = timestamp_ms;
+    b.count++;
+}
+
+size_t NPUHistory::decode_block(const NPUHistoryBlock& b, int64_t from_ms, int64_t to_ms,
+    const std::function<bool(int64_t, const NPUMetric&)>& visit, bool& stopped)
+{
+    Codec c;
+    c.reset(b.first_ms);
+    uint32_t pos = 0;
+    size_t visited = 0;
+    NPUMetric m = NPUMetric();
+    for (uint32_t s = 0; s < b.count; s++)
+    {
+        int64_t delta = c.prev_delta + unzigzag(get_varint(b, pos));
+        c.prev_delta = delta;
+        c.prev_ms += delta;
+
+#define NPU_HISTORY_GET(field, name, help) \
+        get_field(b, pos, m.field, c.prev[NPU_METRIC_##field], c.leading[NPU_METRIC_##field], c.trailing[NPU_METRIC_##field]);
+        NPU_METRIC_LIST(NPU_HISTORY_GET)
+#undef NPU_HISTORY_GET
+
+        //时钟可能回拨，块内后面的样本仍可能落在范围内，不能提前结束
+        if (c.prev_ms < from_ms || c.prev_ms > to_ms)continue;
+        visited++;
+        if (!visit(c.prev_ms, m))
+        {
+            stopped = true;
+            break;
+        }
+    }
+    return visited;
+}
+
+size_t NPUHistory::read(int card_id, int device_id, int64_t from_ms, int64_t to_ms,
+    const std::function<bool(int64_t, const NPUMetric&)>& visit) const
+{
+    const Device* d;
+    {
+        std::lock_guard<std::mutex> lock(map_mutex_);
+        auto it = devices_.find(std::make_pair(card_id, device_id));
+        if (it == devices_.end())return 0;
+        d = it->second.get();
+    }
+
+    //逐块处理：持锁只拷贝下一个范围内的块，解码与visit在锁外进行，不阻塞采样线程，
+    //也不必一次解压整个时间窗；按块序号前进，解码期间被覆盖的块不会重复或遗漏后续块
+    size_t visited = 0;
+    bool stopped = false;
+    uint64_t cursor = 0; //已处理块的序号
+    NPUHistoryBlock copy;
+    while (!stopped)
+    {
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(d->mutex);
+            for (size_t j = 0; j < d->used; j++)
+            {
+                size_t index = (d->head + block_num_ - (d->used - 1) + j) % block_num_;
+                const NPUHistoryBlock& b = d->blocks[index];
+                if (b.count == 0 || b.seq <= cursor || b.max_ms < from_ms || b.min_ms > to_ms)continue;
+                std::memcpy(&copy, &b, sizeof(copy));
+                found = true;
+                break;
+            }
+        }
+        if (!found)break;
+        cursor = copy.seq;
+        visited += decode_block(copy, from_ms, to_ms, visit, stopped);
+    }
+    return visited;
+}
+
+std::vector<NPULabel> NPUHistory::devices() const
+{
+    std::vector<NPULabel> labels;
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    for (const auto& kv : devices_)labels.push_back(kv.second->label);
+    return labels;
+}
+
+size_t NPUHistory::memory_bytes() const
+{
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    return devices_.size() * block_num_ * sizeof(NPUHistoryBlock);
+}
+
+size_t NPUHistory::block_num() const
+{
+    return block_num_;
+}
@@ -0,0 +1,224 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "npu_history_endpoint.h"
+
+namespace {
+
+const size_t FLUSH_BYTES = 16 * 1024; //累计到该大小发送一个分块
+
+/*聚合方式*/
+enum HistoryAgg
+{
+    AGG_AVG,
+    AGG_MIN,
+    AGG_MAX,
+    AGG_LAST
+};
+
+const char* agg_name(HistoryAgg agg)
+{
+    switch (agg)
+    {
+        case AGG_MIN: return "min";
+        case AGG_MAX: return "max";
+        case AGG_LAST: return "last";
+        default: return "avg";
+    }
+}
+
+/*按Prometheus指标名或NPUMetric字段名查找指标编号，找不到返回-1*/
+int find_metric(const std::string& name)
+{
+    static const char* const fields[NPU_METRIC_NUM] = {
+#define NPU_HISTORY_FIELD(field, prom_name, help) #field,
+        NPU_METRIC_LIST(NPU_HISTORY_FIELD)
+#undef NPU_HISTORY_FIELD
+    };
+    for (int k = 0; k < NPU_METRIC_NUM; k++)
+    {
+        if (name == npu_metric_desc(k).name || name == fields[k])return k;
+    }
+    return -1;
+}
+
+/*解析整数参数，非法时返回false*/
+bool parse_int(const std::string& s, int& out)
+{
+    if (s.empty())return false;
+    char* end = nullptr;
+    long v = std::strtol(s.c_str(), &end, 10);
+    if (*end != '\0')return false;
+    out = (int)v;
+    return true;
+}
+
+/*解析以秒为单位的参数，转为毫秒；为空时取def_ms*/
+bool parse_seconds(const std::string& s, int64_t def_ms, int64_t& out_ms)
+{
+    if (s.empty())
+    {
+        out_ms = def_ms;
+        return true;
+    }
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);
+    if (*end != '\0' || !(v >= 0.0) || v > 1e12)return false;
+    out_ms = (int64_t)(v * 1000.0 + 0.5);
+    return true;
+}
+
+/*降采样：按步长分桶聚合，桶结束时输出；step_ms为0时每个样本各自输出*/
+class Downsampler
+{
+public:
+    Downsampler(int64_t from_ms, int64_t step_ms, HistoryAgg agg, const NPUHttpResponse::Writer& write)
+        : from_ms_(from_ms), step_ms_(step_ms), agg_(agg), write_(write), bucket_(-1), count_(0), acc_(0.0), first_(true)
+    {
+        buf_.reserve(FLUSH_BYTES + 64);
+    }
+
+    /*加入一个样本，连接断开时返回false*/
+    bool add(int64_t ts_ms, double v)
+    {
+        if (step_ms_ <= 0)return emit(ts_ms, v);
+        int64_t bucket = (ts_ms - from_ms_) / step_ms_;
+        if (bucket != bucket_ && !close())return false;
+        bucket_ = bucket;
+        if (count_ == 0)acc_ = v;
+        else if (agg_ == AGG_AVG)acc_ += v;
+        else if (agg_ == AGG_MIN)acc_ = v < acc_ ? v : acc_;
+        else if (agg_ == AGG_MAX)acc_ = v > acc_ ? v : acc_;
+        else acc_ = v;
+        count_++;
+        return true;
+    }
+
+    /*输出最后一个桶与剩余内容*/
+    bool finish()
+    {
+        if (!close())return false;
+        return flush();
+    }
+
+private:
+    int64_t from_ms_;
+    int64_t step_ms_;
+    HistoryAgg agg_;
+    const NPUHttpResponse::Writer& write_;
+    int64_t bucket_;
+    uint64_t count_;
+    double acc_;
+    bool first_;
+    std::string buf_;
+
+    bool close()
+    {
+        if (count_ == 0)return true;
+        double v = agg_ == AGG_AVG ? acc_ / (double)count_ : acc_;
+        count_ = 0;
+        return emit(from_ms_ + bucket_ * step_ms_, v);
+    }
+
+    bool emit(int64_t ts_ms, double v)
+    {
+        //JSON没有NaN与无穷大，非有限值（含聚合后溢出的均值）写为null
+        char item[64];
+        int n = std::isfinite(v) ?
+            std::snprintf(item, sizeof(item), "%s[%lld.%03d,%.10g]", first_ ? "" : ",",
+                (long long)(ts_ms / 1000), (int)(ts_ms % 1000), v) :
+            std::snprintf(item, sizeof(item), "%s[%lld.%03d,null]", first_ ? "" : ",",
+                (long long)(ts_ms / 1000), (int)(ts_ms % 1000));
+        first_ = false;
+        buf_.append(item, (size_t)n);
+        return buf_.size() < FLUSH_BYTES || flush();
+    }
+
+    bool flush()
+    {
+        bool ok = write_(buf_.data(), buf_.size());
+        buf_.clear();
+        return ok;
+    }
+};
+
+} // namespace
+
+NPUHistoryEndpoint::NPUHistoryEndpoint(const NPUHistory& history)
+    : history_(history)
+{
+}
+
+void NPUHistoryEndpoint::serve(NPUHttpServer& server, const std::string& path)
+{
+    server.handle(path, [this](const NPUHttpRequest& req, NPUHttpResponse& resp) { handle(req, resp); });
+}
+
+void NPUHistoryEndpoint::handle(const NPUHttpRequest& req, NPUHttpResponse& resp) const
+{
+    int card = 0, device = 0;
+    if (!parse_int(req.param("card"), card) || !parse_int(req.param("device"), device))
+    {
+        resp.status = 400;
+        resp.body = "card and device are required integers\n";
+        return;
+    }
+    std::string metric_name = req.param("metric");
+    int metric = find_metric(metric_name);
+    if (metric < 0)
+    {
+        resp.status = 400;
+        resp.body = "unknown metric '" + metric_name + "'\n";
+        return;
+    }
+
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t to_ms = 0, from_ms = 0, step_ms = 0;
+    if (!parse_seconds(req.param("to"), now_ms, to_ms) ||
+        !parse_seconds(req.param("from"), to_ms - 3600 * 1000, from_ms) ||
+        !parse_seconds(req.param("step"), 0, step_ms) || from_ms > to_ms)
+    {
+        resp.status = 400;
+        resp.body = "from/to/step must be non-negative seconds with from <= to\n";
+        return;
+    }
+
+    std::string agg_param = req.param("agg", "avg");
+    HistoryAgg agg;
+    if (agg_param == "avg")agg = AGG_AVG;
+    else if (agg_param == "min")agg = AGG_MIN;
+    else if (agg_param == "max")agg = AGG_MAX;
+    else if (agg_param == "last")agg = AGG_LAST;
+    else
+    {
+        resp.status = 400;
+        resp.body = "agg must be one of avg, min, max, last\n";
+        return;
+    }
+
+    resp.content_type = "application/json";
+    const NPUHistory& history = history_;
+    resp.stream = [&history, card, device, metric, from_ms, to_ms, step_ms, agg](const NPUHttpResponse::Writer& write) {
+        char head[256];
+        int n = std::snprintf(head, sizeof(head),
+            "{\"card_id\":%d,\"device_id\":%d,\"metric\":\"%s\",\"step\":%lld.%03d,\"agg\":\"%s\",\"values\":[",
+            card, device, npu_metric_desc(metric).name, (long long)(step_ms / 1000), (int)(step_ms % 1000), agg_name(agg));
+        if (!write(head, (size_t)n))return;
+
+        Downsampler downsampler(from_ms, step_ms, agg, write);
+        bool ok = true;
+        history.read(card, device, from_ms, to_ms, [&](int64_t ts_ms, const NPUMetric& m) {
+            double values[NPU_METRIC_NUM];
+            npu_metric_values(m, values);
+            ok = downsampler.add(ts_ms, values[metric]);
+            return ok;
+        });
+        if (!ok || !downsampler.finish())return;
+        write("]}\n", 3);
+    };
+}
@@ -0,0 +1,380 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "npu_http_server.h"
+
+namespace {
+
+const size_t MAX_REQUEST_HEADER = 8192; //请求头上限
+const int IO_TIMEOUT_MS = 5000;         //单次读写无进展的上限（另受连接总时限约束）
+
+typedef std::chrono::steady_clock::time_point Deadline;
+
+const char* status_text(int status)
+{
+    switch (status)
+    {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 503: return "Service Unavailable";
+        default: return "Internal Server Error";
+    }
+}
+
+/*URL解码（%XX与'+'）*/
+std::string url_decode(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if (s[i] == '+')out += ' ';
+        else if (s[i] == '%' && i + 2 < s.size() &&
+                 std::isxdigit((unsigned char)s[i + 1]) && std::isxdigit((unsigned char)s[i + 2]))
+        {
+            out += (char)std::stoi(s.substr(i + 1, 2), nullptr, 16);
+            i += 2;
+        }
+        else out += s[i];
+    }
+    return out;
+}
+
+/*等待非阻塞连接可读/可写，deadline已过或单次等待超过IO_TIMEOUT_MS时返回false*/
+bool wait_ready(int fd, short events, Deadline deadline)
+{
+    while (true)
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)return false;
+        struct pollfd p;
+        p.fd = fd;
+        p.events = events;
+        p.revents = 0;
+        int n = poll(&p, 1, (int)std::min<long long>(remaining, IO_TIMEOUT_MS));
+        if (n < 0 && errno == EINTR)continue;
+        return n > 0;
+    }
+}
+
+/*读取请求数据，连接关闭、出错或超时返回<=0*/
+ssize_t recv_some(int fd, char* buf, size_t size, Deadline deadline)
+{
+    while (true)
+    {
+        ssize_t n = recv(fd, buf, size, 0);
+        if (n >= 0)return n;
+        if (errno == EINTR)continue;
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || !wait_ready(fd, POLLIN, deadline))return -1;
+    }
+}
+
+/*把iov全部写出，失败或超过deadline返回false（对端已关闭时为EPIPE/ECONNRESET，按连接正常结束处理）
+  用sendmsg并带MSG_NOSIGNAL：向已关闭的连接写入时writev会触发SIGPIPE，默认动作是终止整个进程*/
+bool write_all(int fd, struct iovec* iov, int count, Deadline deadline)
+{
+    while (count > 0)
+    {
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)continue;
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_ready(fd, POLLOUT, deadline))continue;
+            return false;
+        }
+        while (count > 0 && (size_t)n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string NPUHttpRequest::header(const std::string& name) const
+{
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+std::string NPUHttpRequest::param(const std::string& name, const std::string& def) const
+{
+    size_t pos = 0;
+    while (pos <= query.size())
+    {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos)end = query.size();
+        size_t eq = query.find('=', pos);
+        if (eq != std::string::npos && eq < end && query.compare(pos, eq - pos, name) == 0 && eq - pos == name.size())
+        {
+            return url_decode(query.substr(eq + 1, end - eq - 1));
+        }
+        pos = end + 1;
+    }
+    return def;
+}
+
+NPUHttpServer::NPUHttpServer(const std::string& bind_address, size_t threads,
+                             std::chrono::milliseconds connection_timeout)
+    : bind_address_(bind_address), thread_num_(threads ? threads : 1), connection_timeout_(connection_timeout),
+      listen_fd_(-1), port_(0), running_(false)
+{
+}
+
+NPUHttpServer::~NPUHttpServer()
+{
+    stop();
+}
+
+void NPUHttpServer::handle(const std::string& path, Handler handler)
+{
+    handlers_[path] = handler;
+}
+
+void NPUHttpServer::start()
+{
+    if (running_)return;
+
+    size_t colon = bind_address_.rfind(':');
+    if (colon == std::string::npos)throw std::runtime_error("invalid bind address: " + bind_address_);
+    std::string host = bind_address_.substr(0, colon);
+    int port = std::atoi(bind_address_.c_str() + colon + 1);
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (host.empty() || host == "0.0.0.0")addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    else if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+    {
+        throw std::runtime_error("invalid bind address: " + bind_address_);
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0)throw std::runtime_error("socket failed: " + std::string(std::strerror(errno)));
+    int on = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd_, 128) != 0)
+    {
+        std::string err = std::strerror(errno);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("bind " + bind_address_ + " failed: " + err);
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, (struct sockaddr*)&addr, &len);
+    port_ = ntohs(addr.sin_port);
+
+    running_ = true;
+    for (size_t i = 0; i < thread_num_; i++)
+    {
+        threads_.emplace_back(&NPUHttpServer::accept_loop, this);
+    }
+}
+
+void NPUHttpServer::stop()
+{
+    if (!running_)return;
+    running_ = false;
+    //shutdown唤醒阻塞在accept上的线程
+    shutdown(listen_fd_, SHUT_RDWR);
+    for (auto& t : threads_)t.join();
+    threads_.clear();
+    close(listen_fd_);
+    listen_fd_ = -1;
+}
+
+int NPUHttpServer::port() const
+{
+    return port_;
+}
+
+void NPUHttpServer::accept_loop()
+{
+    while (running_)
+    {
+        //连接设为非阻塞，读写在总时限内以poll等待
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)continue;
+            if (!running_)return;
+            continue;
+        }
+        serve(fd, std::chrono::steady_clock::now() + connection_timeout_);
+        close(fd);
+    }
+}
+
+void NPUHttpServer::serve(int fd, std::chrono::steady_clock::time_point deadline)
+{
+    //读取请求头
+    std::string raw;
+    char buf[1024];
+    size_t header_end = std::string::npos;
+    while (header_end == std::string::npos)
+    {
+        ssize_t n = recv_some(fd, buf, sizeof(buf), deadline);
+        if (n <= 0)return;
+        raw.append(buf, n);
+        header_end = raw.find("\r\n\r\n");
+        if (header_end == std::string::npos && raw.size() > MAX_REQUEST_HEADER)return;
+    }
+
+    NPUHttpRequest req;
+    NPUHttpResponse resp;
+
+    //请求行：METHOD target HTTP/1.x
+    size_t line_end = raw.find("\r\n");
+    std::string line = raw.substr(0, line_end);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = line.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos)
+    {
+        resp.status = 400;
+    }
+    else
+    {
+        req.method = line.substr(0, sp1);
+        std::string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        size_t q = target.find('?');
+        req.path = target.substr(0, q);
+        if (q != std::string::npos)req.query = target.substr(q + 1);
+
+        //请求头
+        size_t pos = line_end + 2;
+        while (pos < header_end)
+        {
+            size_t end = raw.find("\r\n", pos);
+            size_t colon = raw.find(':', pos);
+            if (colon != std::string::npos && colon < end)
+            {
+                std::string key = raw.substr(pos, colon - pos);
+                for (auto& c : key)c = (char)std::tolower((unsigned char)c);
+                size_t v = colon + 1;
+                while (v < end && raw[v] == ' ')v++;
+                req.headers[key] = raw.substr(v, end - v);
+            }
+            pos = end + 2;
+        }
+
+        auto it = handlers_.find(req.path);
+        if (it == handlers_.end())resp.status = 404;
+        else if (req.method != "GET" && req.method != "HEAD")resp.status = 405;
+        else
+        {
+            try
+            {
+                it->second(req, resp);
+            }
+            catch (const std::exception& e)
+            {
+                resp = NPUHttpResponse();
+                resp.status = 500;
+                resp.body = e.what();
+            }
+        }
+    }
+
+    if (resp.status == 200 && resp.stream)
+    {
+        send_stream(fd, req, resp, deadline);
+        return;
+    }
+
+    const char* data = resp.data ? resp.data : resp.body.data();
+    size_t size = resp.data ? resp.size : resp.body.size();
+    if (resp.status != 200 && resp.body.empty() && resp.data == nullptr)
+    {
+        resp.body = status_text(resp.status);
+        data = resp.body.data();
+        size = resp.body.size();
+    }
+
+    std::string head = "HTTP/1.1 " + std::to_string(resp.status) + " " + status_text(resp.status) + "\r\n";
+    head += "Content-Type: " + resp.content_type + "\r\n";
+    if (!resp.content_encoding.empty())head += "Content-Encoding: " + resp.content_encoding + "\r\n";
+    for (const auto& h : resp.headers)head += h.first + ": " + h.second + "\r\n";
+    head += "Content-Length: " + std::to_string(size) + "\r\n";
+    head += "Connection: close\r\n\r\n";
+
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)head.data();
+    iov[0].iov_len = head.size();
+    iov[1].iov_base = (void*)data;
+    iov[1].iov_len = req.method == "HEAD" ? 0 : size;
+    write_all(fd, iov, iov[1].iov_len ? 2 : 1, deadline);
+}
+
+void NPUHttpServer::send_stream(int fd, const NPUHttpRequest& req, NPUHttpResponse& resp,
+                                std::chrono::steady_clock::time_point deadline)
+{
+    std::string head = "HTTP/1.1 200 OK\r\n";
+    head += "Content-Type: " + resp.content_type + "\r\n";
+    if (!resp.content_encoding.empty())head += "Content-Encoding: " + resp.content_encoding + "\r\n";
+    for (const auto& h : resp.headers)head += h.first + ": " + h.second + "\r\n";
+    head += "Transfer-Encoding: chunked\r\n";
+    head += "Connection: close\r\n\r\n";
+    struct iovec iov[1];
+    iov[0].iov_base = (void*)head.data();
+    iov[0].iov_len = head.size();
+    if (!write_all(fd, iov, 1, deadline) || req.method == "HEAD")return;
+
+    //每个分块：十六进制长度 CRLF 数据 CRLF；长度为0的分块表示结束
+    bool ok = true;
+    //到达总时限后写入失败，生成方随之停止
+    NPUHttpResponse::Writer writer = [fd, deadline, &ok](const char* data, size_t size) {
+        if (!ok)return false;
+        if (size == 0)return true;
+        char len[24];
+        int n = std::snprintf(len, sizeof(len), "%zx\r\n", size);
+        struct iovec chunk[3];
+        chunk[0].iov_base = len;
+        chunk[0].iov_len = (size_t)n;
+        chunk[1].iov_base = (void*)data;
+        chunk[1].iov_len = size;
+        chunk[2].iov_base = (void*)"\r\n";
+        chunk[2].iov_len = 2;
+        ok = write_all(fd, chunk, 3, deadline);
+        return ok;
+    };
+    try
+    {
+        resp.stream(writer);
+    }
+    catch (const std::exception&)
+    {
+        //响应头已发出，只能中断连接，客户端会看到不完整的分块流
+        return;
+    }
+    if (!ok)return;
+    iov[0].iov_base = (void*)"0\r\n\r\n";
+    iov[0].iov_len = 5;
+    write_all(fd, iov, 1, deadline);
+}
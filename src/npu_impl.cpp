@@ -1,15 +1,54 @@
-#include <assert.h>
-#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <utility>
 #include "npu_impl.h"
+#include "npu_logger.h"
 #include "dcmi_interface_api.h"
 
 #define NPU_OK (0)
 
-NPUImpl::NPUImpl()
+/*各采样分组包含的字段（NPU_METRIC_BIT掩码，按NPUMetricGroup编号）*/
+static const uint32_t GROUP_FIELDS[NPU_GROUP_NUM] = {
+    NPU_METRIC_BIT(util_aicore) | NPU_METRIC_BIT(util_aicpu) | NPU_METRIC_BIT(util_mem) | NPU_METRIC_BIT(power),
+    NPU_METRIC_BIT(aicore_freq) | NPU_METRIC_BIT(aicpu_freq) | NPU_METRIC_BIT(mem_freq) | NPU_METRIC_BIT(voltage),
+    NPU_METRIC_BIT(temperature),
+    NPU_METRIC_BIT(health),
+    NPU_METRIC_BIT(hbm_total) | NPU_METRIC_BIT(hbm_used) | NPU_METRIC_BIT(hbm_temperature) | NPU_METRIC_BIT(util_hbm_bw)
+};
+
+/*设备已不存在（如卡被移除或复位）的返回值*/
+static bool device_lost(int ret)
+{
+    return ret == DCMI_ERR_CODE_DEVICE_NOT_EXIST || ret == DCMI_ERR_CODE_INVALID_DEVICE_ID;
+}
+
+/*计时执行一次DCMI调用，把耗时与是否失败记入stats；设备不存在时置lost，提前触发重新枚举*/
+template<typename F>
+static int timed_call(NPUCallStats& stats, size_t slot, std::atomic<bool>& lost, NPUDcmiCall call, F dcmi_call)
+{
+    auto start = std::chrono::steady_clock::now();
+    int ret = dcmi_call();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    stats.record(slot, call, (uint64_t)ns, ret != NPU_OK);
+    if (device_lost(ret))lost.store(true, std::memory_order_relaxed);
+    return ret;
+}
+
+NPUImpl::NPUImpl(NPUSampleMode mode, int workers)
+    : mode(mode), worker_num(workers),
+      cycle_deadline(std::chrono::steady_clock::duration::zero()), cycle_seq(0), job_cycle(0), job_due(0),
+      rediscover_interval(std::chrono::steady_clock::duration::zero()), rediscover_hint(false),
+      enumerated_count(-1), stats_slot_count(0)
 {
     int ret = dcmi_init();
     if(ret!=NPU_OK)raise_error("dcmi_init failed",ret,-1,-1,true);
     is_label_initialized=false;
+    for (int g = 0; g < NPU_GROUP_NUM; g++)
+    {
+        group_interval[g] = std::chrono::steady_clock::duration::zero();
+        group_next[g] = std::chrono::steady_clock::time_point::min();
+    }
 }
 
 std::string NPUImpl::name() const
@@ -17,18 +56,50 @@ std::string NPUImpl::name() const
     return "ascend_npu";
 }
 
-std::vector<NPULabel> NPUImpl::labels()
+const std::vector<NPULabel>& NPUImpl::labels()
 {
-    if(is_label_initialized)return label_list;
+    if(is_label_initialized)
+    {
+        //到期或设备报告不存在时重新枚举
+        auto now = std::chrono::steady_clock::now();
+        bool hinted = rediscover_hint.exchange(false, std::memory_order_relaxed);
+        if (rediscover_interval > std::chrono::steady_clock::duration::zero() &&
+            (hinted || now >= rediscover_next))
+        {
+            rediscover_next = now + rediscover_interval;
+            rediscover(hinted);
+        }
+        return label_list;
+    }
     is_label_initialized=true;
+    rediscover_next = std::chrono::steady_clock::now() + rediscover_interval;
+
+    //首次枚举失败不再退出：以空设备集启动，由重新枚举补上
+    std::vector<NPULabel> found;
+    int card_count = 0;
+    int all_count = 0;
+    bool complete = false;
+    int ret = dcmi_get_all_device_count(&all_count);
+    if (enumerate_devices(found, card_count, complete))enumerated_count = ret == NPU_OK && complete ? all_count : -1;
+    else found.clear();
+    apply_labels(found, card_count, false);
+    return label_list;
+}
+
+/*枚举当前所有卡和设备*/
+bool NPUImpl::enumerate_devices(std::vector<NPULabel>& found, int& card_count, bool& complete)
+{
     //获取卡列表
     int ret;
-    int card_count = 0;
+    card_count = 0;
+    complete = true;
     int card_list[MAX_CARD_NUM] = {0};
     ret=dcmi_get_card_list(&card_count, card_list, MAX_CARD_NUM);
-    if(ret!=NPU_OK)raise_error("dcmi_get_card_list failed",ret,-1,-1,true);
-    
-    assert(card_count!=0);
+    if(ret!=NPU_OK)
+    {
+        raise_error("dcmi_get_card_list failed",ret,-1,-1,false);
+        return false;
+    }
 
     //遍历每个卡和设备
     for (int i = 0; i < card_count; i++)
@@ -39,147 +110,429 @@ std::vector<NPULabel> NPUImpl::labels()
 
         if(ret!=NPU_OK)
         {
-            raise_error("dcmi_get_device_id_in_card failed",ret,card,-1,true);
+            //单卡失败（如复位中）只跳过该卡
+            raise_error("dcmi_get_device_id_in_card failed",ret,card,-1,false);
+            complete = false;
             continue;
         }
 
-        for (int dev = 0; dev < device_count; dev++)
+        for (int dev = 0; dev < device_count && found.size() < NPU_MAX_DEVICE_NUM; dev++)
         {
             NPULabel label;
             label.card_id = card;
             label.device_id = dev;
-            label_list.push_back(label);
+            found.push_back(label);
         }
     }
-    return label_list;
+    return true;
 }
-    
-/*采集所有设备的指标数据*/
-std::vector<NPUMetric> NPUImpl::sample()
+
+/*设置重新枚举的间隔*/
+void NPUImpl::set_rediscover_interval(std::chrono::milliseconds interval)
 {
-    if(!is_label_initialized)raise_error("label hasn't been called",-1,-1,-1,true);
-    std::vector<NPUMetric> metrics;
-    //为每个设备采集数据
-    for (const auto& label : label_list)
+    rediscover_interval = interval;
+    rediscover_next = std::chrono::steady_clock::now() + interval;
+}
+
+/*重新枚举设备，与当前设备集比较并增量更新*/
+bool NPUImpl::rediscover(bool force)
+{
+    if(!is_label_initialized)return false;
+    //有工作线程卡在驱动调用中时，其仍在访问各设备状态，推迟到其返回后
+    if (pool && !pool->idle())
     {
-        NPUMetric metric;
-        collect_single_device(label.card_id, label.device_id, metric);
-        metrics.push_back(metric);
+        if (force)rediscover_hint.store(true, std::memory_order_relaxed);
+        return false;
     }
-    return metrics;
+
+    //快速检查：驱动报告的设备总数与上次完整枚举时相同则跳过完整枚举
+    //与驱动的原始计数比较，而不是label_list的大小（后者受NPU_MAX_DEVICE_NUM限制且不含枚举失败的卡）；
+    //只能发现数量变化，数量不变的设备替换由设备报告不存在（rediscover_hint）或force触发完整枚举
+    int all_count = 0;
+    int ret = dcmi_get_all_device_count(&all_count);
+    if (!force && ret == NPU_OK && all_count == enumerated_count)return false;
+
+    std::vector<NPULabel> found;
+    int card_count = 0;
+    bool complete = false;
+    if (!enumerate_devices(found, card_count, complete))return false;
+    //有卡枚举失败时不记录计数，下次到期仍做完整枚举
+    enumerated_count = ret == NPU_OK && complete ? all_count : -1;
+
+    bool same = found.size() == label_list.size();
+    for (size_t i = 0; same && i < found.size(); i++)
+    {
+        same = found[i].card_id == label_list[i].card_id && found[i].device_id == label_list[i].device_id;
+    }
+    if (same)return false;
+    apply_labels(found, card_count, true);
+    return true;
 }
 
-/*采集单个设备的指标*/
-void NPUImpl::collect_single_device(int card, int device, NPUMetric& metric)
+/*切换到新的设备集：保留的设备沿用其状态，新设备从零开始，移除的设备释放状态*/
+void NPUImpl::apply_labels(const std::vector<NPULabel>& found, int card_count, bool log_changes)
 {
-    int ret;
-    /*利用率*/
-    unsigned int util_aicore = 0, util_aicpu = 0, util_mem = 0;
-    //AICore
-    ret=dcmi_get_device_utilization_rate(card, device, 2, &util_aicore);
-    if (ret== NPU_OK)metric.util_aicore = util_aicore;
-    else
+    std::vector<NPUMetric> new_device_metrics(found.size(), NPUMetric());
+    std::vector<NPUMetric> new_good_metrics(found.size(), NPUMetric());
+    std::vector<size_t> new_stats_slot(found.size(), (size_t)-1);
+    std::vector<bool> retained(label_list.size(), false);
+
+    //按(卡, 设备)匹配旧设备
+    std::map<std::pair<int, int>, size_t> old_index;
+    for (size_t i = 0; i < label_list.size(); i++)
     {
-        metric.util_aicore = 0;
-        raise_error("get AICore utilization rate failed",ret,card,device,false);
+        old_index[std::make_pair(label_list[i].card_id, label_list[i].device_id)] = i;
     }
-    //AICPU
-    ret=dcmi_get_device_utilization_rate(card, device, 3, &util_aicpu);
-    if (ret== NPU_OK)metric.util_aicpu = util_aicpu;
-    else
+    for (size_t i = 0; i < found.size(); i++)
     {
-        metric.util_aicpu = 0;
-        raise_error("get AICPU utilization rate failed",ret,card,device,false);
+        auto it = old_index.find(std::make_pair(found[i].card_id, found[i].device_id));
+        if (it == old_index.end())continue;
+        new_device_metrics[i] = device_metrics[it->second];
+        new_good_metrics[i] = good_metrics[it->second];
+        new_stats_slot[i] = stats_slot[it->second];
+        retained[it->second] = true;
     }
-    //Mem
-    ret=dcmi_get_device_utilization_rate(card, device, 1, &util_mem);
-    if (ret== NPU_OK)metric.util_mem = util_mem;
-    else
+
+    //释放移除设备的统计槽位
+    for (size_t i = 0; i < label_list.size(); i++)
+    {
+        if (retained[i])continue;
+        if (log_changes)NPULogger::instance().info("device retired",label_list[i].card_id,label_list[i].device_id);
+        call_stats.reset_device(stats_slot[i], -1, -1);
+        free_stats_slots.push_back(stats_slot[i]);
+    }
+    //为新设备分配统计槽位
+    for (size_t i = 0; i < found.size(); i++)
     {
-        metric.util_mem = 0;
-        raise_error("get Mem utilization rate failed",ret,card,device,false);
+        if (new_stats_slot[i] != (size_t)-1)continue;
+        if (log_changes)NPULogger::instance().info("device added",found[i].card_id,found[i].device_id);
+        size_t slot;
+        if (!free_stats_slots.empty())
+        {
+            slot = free_stats_slots.back();
+            free_stats_slots.pop_back();
+        }
+        else slot = stats_slot_count++;
+        call_stats.reset_device(slot, found[i].card_id, found[i].device_id);
+        new_stats_slot[i] = slot;
     }
+    call_stats.set_device_count(stats_slot_count);
 
-    /*频率*/
-    //AICore
-    struct dcmi_aicore_info aicore = {0};
-    ret=dcmi_get_device_aicore_info(card, device, &aicore);
-    if (ret== NPU_OK)metric.aicore_freq = aicore.cur_freq;
-    else
+    label_list = found;
+    device_metrics.swap(new_device_metrics);
+    good_metrics.swap(new_good_metrics);
+    stats_slot.swap(new_stats_slot);
+    device_done.reset(new std::atomic<uint64_t>[label_list.size()]);
+    for (size_t i = 0; i < label_list.size(); i++)device_done[i].store(0);
+    if(mode==NPUSampleMode::PARALLEL)init_workers(card_count);
+}
+
+/*设置分组的采样间隔*/
+void NPUImpl::set_group_interval(NPUMetricGroup group, std::chrono::milliseconds interval)
+{
+    if (group < 0 || group >= NPU_GROUP_NUM)return;
+    group_interval[group] = interval;
+    group_next[group] = std::chrono::steady_clock::time_point::min();
+}
+
+/*设置每个采样周期的截止时间*/
+void NPUImpl::set_cycle_deadline(std::chrono::milliseconds deadline)
+{
+    cycle_deadline = deadline;
+}
+
+/*各设备DCMI调用的耗时与错误统计*/
+const NPUCallStats& NPUImpl::dcmi_call_stats() const
+{
+    return call_stats;
+}
+
+/*计算本周期到期的分组*/
+unsigned int NPUImpl::due_groups()
+{
+    auto now = std::chrono::steady_clock::now();
+    unsigned int due = 0;
+    for (int g = 0; g < NPU_GROUP_NUM; g++)
     {
-        metric.aicore_freq = 0;
-        raise_error("get AICore Frequency failed",ret,card,device,false);
+        if (now < group_next[g])continue;
+        due |= NPU_GROUP_BIT(g);
+        //按节拍推进；落后超过一个间隔时从当前时刻重新计时
+        if (group_next[g] == std::chrono::steady_clock::time_point::min() || now - group_next[g] >= group_interval[g])
+        {
+            group_next[g] = now + group_interval[g];
+        }
+        else group_next[g] += group_interval[g];
     }
-    //AICPU
-    struct dcmi_aicpu_info aicpu = {0};
-    ret=dcmi_get_device_aicpu_info(card, device, &aicpu);
-    if (ret == NPU_OK)metric.aicpu_freq = aicpu.cur_freq;
-    else
+    return due;
+}
+
+/*按卡把设备划分给工作线程，并创建线程池*/
+void NPUImpl::init_workers(int card_count)
+{
+    //同一张卡的设备由同一个工作线程负责，默认每卡一个线程
+    size_t n = worker_num > 0 ? (size_t)worker_num : (size_t)card_count;
+    if (n == 0)n = 1;
+    worker_devices.assign(n, std::vector<size_t>());
+
+    int card_index = -1;
+    int last_card = -1;
+    for (size_t i = 0; i < label_list.size(); i++)
     {
-        metric.aicpu_freq = 0;
-        raise_error("get AICPU Frequency failed",ret,card,device,false);
+        if (i == 0 || label_list[i].card_id != last_card)
+        {
+            last_card = label_list[i].card_id;
+            card_index++;
+        }
+        worker_devices[card_index % n].push_back(i);
     }
-    //Mem
-    unsigned int mem_freq;
-    ret=dcmi_get_device_frequency(card,device,(enum dcmi_freq_type)1,&mem_freq);
-    if(ret==NPU_OK)metric.mem_freq=mem_freq;
-    else
+    worker_task = [this](size_t worker) { worker_job(worker); };
+    //重新枚举时线程数不变则沿用原线程池（此时所有工作线程空闲）
+    if (!pool || pool->size() != n)pool.reset(new NPUWorkerPool(n));
+}
+
+/*工作线程任务：采集worker负责的设备并登记完成周期*/
+void NPUImpl::worker_job(size_t worker)
+{
+    //周期参数在开始时取一次，超时后继续执行也不会读到调用者栈上的数据
+    uint64_t cycle = job_cycle.load(std::memory_order_acquire);
+    unsigned int due = job_due.load(std::memory_order_relaxed);
+    for (size_t i : worker_devices[worker])
     {
-        metric.mem_freq=0;
-        raise_error("get Mem Frequency failed",ret,card,device,false);
+        collect_single_device(i, due);
+        device_done[i].store(cycle, std::memory_order_release);
     }
+}
+    
+/*采集所有设备的指标数据*/
+std::vector<NPUMetric> NPUImpl::sample()
+{
+    std::vector<NPUMetric> metrics;
+    sample(metrics);
+    return metrics;
+}
 
-    /*功耗*/
-    int power = 0;
-    ret=dcmi_get_device_power_info(card, device, &power);
-    if (ret == NPU_OK)metric.power = (double)power/10.0;
+/*采集所有设备的指标数据到metrics*/
+void NPUImpl::sample(std::vector<NPUMetric>& metrics)
+{
+    if(!is_label_initialized)raise_error("label hasn't been called",-1,-1,-1,true);
+    unsigned int due = due_groups();
+    uint64_t cycle = ++cycle_seq;
+    bool bounded = cycle_deadline > std::chrono::steady_clock::duration::zero();
+    //设备先在工作区采集，按时完成的再拷贝为对外读数；未完成的沿用上次读数并标记stale
+    if (pool)
+    {
+        //并行：每个工作线程采集自己负责的设备，耗时取决于最慢的卡（有截止时间时不超过截止时间）
+        job_due.store(due, std::memory_order_relaxed);
+        job_cycle.store(cycle, std::memory_order_release);
+        pool->run_until(worker_task, bounded ? std::chrono::steady_clock::now() + cycle_deadline
+                                             : std::chrono::steady_clock::time_point::max());
+        for (size_t i = 0; i < label_list.size(); i++)
+        {
+            if (device_done[i].load(std::memory_order_acquire) == cycle)
+            {
+                good_metrics[i] = device_metrics[i];
+                good_metrics[i].stale = 0;
+            }
+            else good_metrics[i].stale = 1;
+        }
+    }
     else
     {
-        metric.power = 0;
-        raise_error("get power failed",ret,card,device,false);
+        //串行：为每个设备采集数据（截止时间不适用：卡住的调用会阻塞整个周期，
+        //在其返回后再把剩余设备标为stale只会丢掉正常设备的读数）
+        for (size_t i = 0; i < label_list.size(); i++)
+        {
+            collect_single_device(i, due);
+            good_metrics[i] = device_metrics[i];
+            good_metrics[i].stale = 0;
+        }
+    }
+    metrics = good_metrics;
+}
+
+/*采集单个设备中本周期到期的分组，未到期分组保留上次读数*/
+void NPUImpl::collect_single_device(size_t index, unsigned int due)
+{
+    int card = label_list[index].card_id;
+    int device = label_list[index].device_id;
+    NPUMetric& metric = device_metrics[index];
+    unsigned int failed = 0;
+    int ret;
+    if (due & NPU_GROUP_BIT(NPU_GROUP_UTIL_POWER))
+    {
+        /*利用率*/
+        unsigned int util_aicore = 0, util_aicpu = 0, util_mem = 0;
+        //AICore
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_UTIL_AICORE, [&] { return dcmi_get_device_utilization_rate(card, device, 2, &util_aicore); });
+        if (ret== NPU_OK)metric.util_aicore = util_aicore;
+        else
+        {
+            metric.util_aicore = 0;
+            raise_error("get AICore utilization rate failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(util_aicore);
+        }
+        //AICPU
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_UTIL_AICPU, [&] { return dcmi_get_device_utilization_rate(card, device, 3, &util_aicpu); });
+        if (ret== NPU_OK)metric.util_aicpu = util_aicpu;
+        else
+        {
+            metric.util_aicpu = 0;
+            raise_error("get AICPU utilization rate failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(util_aicpu);
+        }
+        //Mem
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_UTIL_MEM, [&] { return dcmi_get_device_utilization_rate(card, device, 1, &util_mem); });
+        if (ret== NPU_OK)metric.util_mem = util_mem;
+        else
+        {
+            metric.util_mem = 0;
+            raise_error("get Mem utilization rate failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(util_mem);
+        }
+
+        /*功耗*/
+        int power = 0;
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_POWER_INFO, [&] { return dcmi_get_device_power_info(card, device, &power); });
+        if (ret == NPU_OK)metric.power = (double)power/10.0;
+        else
+        {
+            metric.power = 0;
+            raise_error("get power failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(power);
+        }
+    }
+
+    if (due & NPU_GROUP_BIT(NPU_GROUP_FREQ_VOLTAGE))
+    {
+        /*频率*/
+        //AICore
+        struct dcmi_aicore_info aicore = {0};
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_AICORE_INFO, [&] { return dcmi_get_device_aicore_info(card, device, &aicore); });
+        if (ret== NPU_OK)metric.aicore_freq = aicore.cur_freq;
+        else
+        {
+            metric.aicore_freq = 0;
+            raise_error("get AICore Frequency failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(aicore_freq);
+        }
+        //AICPU
+        struct dcmi_aicpu_info aicpu = {0};
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_AICPU_INFO, [&] { return dcmi_get_device_aicpu_info(card, device, &aicpu); });
+        if (ret == NPU_OK)metric.aicpu_freq = aicpu.cur_freq;
+        else
+        {
+            metric.aicpu_freq = 0;
+            raise_error("get AICPU Frequency failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(aicpu_freq);
+        }
+        //Mem
+        unsigned int mem_freq;
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_FREQ_MEM, [&] { return dcmi_get_device_frequency(card,device,(enum dcmi_freq_type)1,&mem_freq); });
+        if(ret==NPU_OK)metric.mem_freq=mem_freq;
+        else
+        {
+            metric.mem_freq=0;
+            raise_error("get Mem Frequency failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(mem_freq);
+        }
+
+        //电压
+        unsigned int voltage = 0;
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_VOLTAGE, [&] { return dcmi_get_device_voltage(card, device, &voltage); });
+        if (ret == NPU_OK)metric.voltage = (double)voltage/100.0;
+        else
+        {
+            metric.voltage = 0;
+            raise_error("get voltage failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(voltage);
+        }
     }
 
     /*其他*/
-    //健康状态
-    unsigned int health = 0;
-    ret=dcmi_get_device_health(card, device, &health);
-    if (ret == NPU_OK)metric.health = health;
-    else
+    if (due & NPU_GROUP_BIT(NPU_GROUP_HEALTH))
     {
-        metric.health = 0xFFFFFFFF;
-        raise_error("get health failed",ret,card,device,false);
+        //健康状态
+        unsigned int health = 0;
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_HEALTH, [&] { return dcmi_get_device_health(card, device, &health); });
+        if (ret == NPU_OK)metric.health = health;
+        else
+        {
+            metric.health = 0xFFFFFFFF;
+            raise_error("get health failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(health);
+        }
     }
-    
-    //温度
-    int temperature = 0;
-    ret=dcmi_get_device_temperature(card, device, &temperature);
-    if (ret == NPU_OK)metric.temperature = temperature;
-    else
+
+    if (due & NPU_GROUP_BIT(NPU_GROUP_TEMPERATURE))
     {
-        metric.temperature = 0;
-        raise_error("get temperature failed",ret,card,device,false);
+        //温度
+        int temperature = 0;
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_TEMPERATURE, [&] { return dcmi_get_device_temperature(card, device, &temperature); });
+        if (ret == NPU_OK)metric.temperature = temperature;
+        else
+        {
+            metric.temperature = 0;
+            raise_error("get temperature failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(temperature);
+        }
     }
-    
-    //电压
-    unsigned int voltage = 0;
-    ret=dcmi_get_device_voltage(card, device, &voltage);
-    if (ret == NPU_OK)metric.voltage = (double)voltage/100.0;
-    else
+
+    if (due & NPU_GROUP_BIT(NPU_GROUP_HBM))
     {
-        metric.voltage = 0;
-        raise_error("get voltage failed",ret,card,device,false);
+        /*HBM*/
+        //容量、温度（驱动以MB为单位上报容量）
+        struct dcmi_hbm_info hbm = {0};
+        int hbm_ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_HBM_INFO, [&] { return dcmi_get_device_hbm_info(card, device, &hbm); });
+        if (hbm_ret == NPU_OK)
+        {
+            metric.hbm_total = hbm.memory_size * 1024ULL * 1024ULL;
+            metric.hbm_used = hbm.memory_usage * 1024ULL * 1024ULL;
+            metric.hbm_temperature = hbm.temp;
+        }
+        else
+        {
+            metric.hbm_total = 0;
+            metric.hbm_used = 0;
+            metric.hbm_temperature = 0;
+            raise_error("get HBM info failed",hbm_ret,card,device,false);
+            failed |= NPU_METRIC_BIT(hbm_total) | NPU_METRIC_BIT(hbm_used) | NPU_METRIC_BIT(hbm_temperature);
+        }
+        //带宽利用率：不支持该查询的芯片改用HBM信息中的带宽利用率
+        unsigned int util_hbm_bw = 0;
+        ret=timed_call(call_stats, stats_slot[index], rediscover_hint, NPU_CALL_UTIL_HBM_BW, [&] { return dcmi_get_device_utilization_rate(card, device, DCMI_UTILIZATION_RATE_HBM_BANDWIDTH, &util_hbm_bw); });
+        if (ret == NPU_OK)metric.util_hbm_bw = util_hbm_bw;
+        else if (hbm_ret == NPU_OK)metric.util_hbm_bw = hbm.bandwith_util_rate;
+        else
+        {
+            metric.util_hbm_bw = 0;
+            raise_error("get HBM bandwidth utilization rate failed",ret,card,device,false);
+            failed |= NPU_METRIC_BIT(util_hbm_bw);
+        }
+    }
+    //本周期采集的字段按结果更新失败标记，未到期分组的字段保留上次的标记
+    uint32_t read = 0;
+    for (int g = 0; g < NPU_GROUP_NUM; g++)
+    {
+        if (due & NPU_GROUP_BIT(g))read |= GROUP_FIELDS[g];
     }
+    metric.failed = (metric.failed & ~read) | failed;
 }
 
-/*错误信息*/
-void NPUImpl::raise_error(const std::string&msg, int ret,int card,int dev,bool fatal)
+/*错误信息：交给异步日志器，采样热路径上不做阻塞写入与flush*/
+void NPUImpl::raise_error(const char* msg, int ret,int card,int dev,bool fatal)
 {
-    std::string out;
-    out += fatal ? "[FATAL] " : "[WARNING] ";
-    out += msg;
-    out += "(ret=" + std::to_string(ret)+") ";
-    if (card >= 0)out += "(card=" + std::to_string(card)+") ";
-    if (dev >= 0)out += "(dev=" + std::to_string(dev)+") ";
-    std::cerr << out << std::endl;
-    if (fatal)std::exit(EXIT_FAILURE);
-}
\ No newline at end of file
+    NPULogger& logger = NPULogger::instance();
+    if (!fatal)
+    {
+        logger.log(msg, ret, card, dev, false);
+        return;
+    }
+    //致命错误：同步输出全部日志后退出
+    if (!logger.log(msg, ret, card, dev, true))
+    {
+        logger.flush();
+        logger.log(msg, ret, card, dev, true);
+    }
+    logger.flush();
+    std::exit(EXIT_FAILURE);
+}
@@ -0,0 +1,233 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <set>
+#include <utility>
+
+#include "npu_journal.h"
+#include "npu_logger.h"
+
+namespace {
+
+const char JOURNAL_MAGIC[8] = {'N', 'P', 'U', 'J', 'R', 'N', 'L', '1'};
+const uint32_t JOURNAL_VERSION = 1;
+const size_t HEADER_BYTES = 4096; //文件头占一页，记录区按页对齐
+
+/*CRC32（IEEE），用于识别写到一半的记录*/
+struct Crc32Table
+{
+    uint32_t table[256];
+    Crc32Table()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+};
+const Crc32Table CRC32;
+
+uint32_t crc32(const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)c = CRC32.table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+uint32_t record_crc(const NPUJournalRecord& r)
+{
+    return crc32(&r, offsetof(NPUJournalRecord, crc));
+}
+
+} // namespace
+
+NPUJournal::NPUJournal(std::chrono::milliseconds flush_interval)
+    : flush_interval_(flush_interval), fd_(-1), map_(nullptr), map_size_(0),
+      records_(nullptr), record_num_(0), next_seq_(1), stopping_(false)
+{
+}
+
+NPUJournal::~NPUJournal()
+{
+    close();
+}
+
+bool NPUJournal::open(const std::string& path, size_t bytes)
+{
+    close();
+    size_t record_num = bytes > HEADER_BYTES ? (bytes - HEADER_BYTES) / sizeof(NPUJournalRecord) : 0;
+    if (record_num == 0)return false;
+    size_t size = HEADER_BYTES + record_num * sizeof(NPUJournalRecord);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        NPULogger::instance().log("open journal failed", errno, -1, -1, false);
+        return false;
+    }
+
+    //文件头与当前格式一致时沿用原内容，否则重新初始化
+    Header expected;
+    std::memset(&expected, 0, sizeof(expected));
+    std::memcpy(expected.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    expected.version = JOURNAL_VERSION;
+    expected.record_size = sizeof(NPUJournalRecord);
+    expected.record_num = record_num;
+    expected.metric_num = NPU_METRIC_NUM;
+
+    struct stat st;
+    Header existing;
+    bool reuse = fstat(fd, &st) == 0 && (size_t)st.st_size == size &&
+                 pread(fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing) &&
+                 std::memcmp(&existing, &expected, sizeof(expected)) == 0;
+    if (!reuse)
+    {
+        //预分配全部空间，映射区写入时不会因磁盘满而SIGBUS
+        if (ftruncate(fd, 0) != 0 || posix_fallocate(fd, 0, (off_t)size) != 0 ||
+            pwrite(fd, &expected, sizeof(expected), 0) != (ssize_t)sizeof(expected))
+        {
+            NPULogger::instance().log("create journal failed", errno, -1, -1, false);
+            ::close(fd);
+            return false;
+        }
+    }
+
+    //预先载入所有页，采样线程写入时不触发缺页读盘
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        NPULogger::instance().log("mmap journal failed", errno, -1, -1, false);
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    map_ = (char*)map;
+    map_size_ = size;
+    records_ = (NPUJournalRecord*)(map_ + HEADER_BYTES);
+    record_num_ = record_num;
+
+    //从最大的有效序号之后继续写
+    next_seq_ = 1;
+    for (size_t i = 0; i < record_num_; i++)
+    {
+        const NPUJournalRecord& r = records_[i];
+        if (r.seq == 0 || r.seq % record_num_ != i || r.crc != record_crc(r))continue;
+        if (r.seq >= next_seq_)next_seq_ = r.seq + 1;
+    }
+
+    stopping_ = false;
+    thread_ = std::thread(&NPUJournal::run, this);
+    return true;
+}
+
+void NPUJournal::close()
+{
+    if (map_ == nullptr)return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())thread_.join();
+    msync(map_, map_size_, MS_SYNC);
+    munmap(map_, map_size_);
+    ::close(fd_);
+    fd_ = -1;
+    map_ = nullptr;
+    map_size_ = 0;
+    records_ = nullptr;
+    record_num_ = 0;
+}
+
+bool NPUJournal::is_open() const
+{
+    return map_ != nullptr;
+}
+
+size_t NPUJournal::capacity() const
+{
+    return record_num_;
+}
+
+size_t NPUJournal::replay(
+    const std::function<void(int64_t, const std::vector<NPULabel>&, const std::vector<NPUMetric>&)>& visit) const
+{
+    if (map_ == nullptr)return 0;
+
+    //有效记录按序号排序，时间戳相同且设备不重复的相邻记录属于同一周期
+    //（周期中间的记录损坏只留下序号空洞，不把该周期拆成两次visit）
+    std::vector<const NPUJournalRecord*> valid;
+    for (size_t i = 0; i < record_num_; i++)
+    {
+        const NPUJournalRecord& r = records_[i];
+        if (r.seq == 0 || r.seq % record_num_ != i || r.crc != record_crc(r))continue;
+        valid.push_back(&r);
+    }
+    std::sort(valid.begin(), valid.end(),
+        [](const NPUJournalRecord* a, const NPUJournalRecord* b) { return a->seq < b->seq; });
+
+    size_t cycles = 0;
+    std::vector<NPULabel> labels;
+    std::vector<NPUMetric> metrics;
+    std::set<std::pair<int, int>> seen;
+    for (size_t i = 0; i < valid.size(); i++)
+    {
+        labels.push_back(valid[i]->label);
+        metrics.push_back(valid[i]->metric);
+        seen.insert(std::make_pair(valid[i]->label.card_id, valid[i]->label.device_id));
+        bool last = i + 1 == valid.size() ||
+                    valid[i + 1]->timestamp_ms != valid[i]->timestamp_ms ||
+                    seen.count(std::make_pair(valid[i + 1]->label.card_id, valid[i + 1]->label.device_id)) != 0;
+        if (!last)continue;
+        visit(valid[i]->timestamp_ms, labels, metrics);
+        labels.clear();
+        metrics.clear();
+        seen.clear();
+        cycles++;
+    }
+    return cycles;
+}
+
+void NPUJournal::append(int64_t timestamp_ms, const std::vector<NPULabel>& labels, const std::vector<NPUMetric>& metrics)
+{
+    if (map_ == nullptr)return;
+    size_t n = std::min(labels.size(), metrics.size());
+    for (size_t i = 0; i < n; i++)
+    {
+        //在栈上组装并计算校验，再整条拷入映射区
+        NPUJournalRecord r;
+        std::memset(&r, 0, sizeof(r));
+        r.seq = next_seq_++;
+        r.timestamp_ms = timestamp_ms;
+        r.label = labels[i];
+        r.metric = metrics[i];
+        r.crc = record_crc(r);
+        std::memcpy(&records_[r.seq % record_num_], &r, sizeof(r));
+    }
+}
+
+void NPUJournal::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        cv_.wait_for(lock, flush_interval_, [this] { return stopping_; });
+        if (stopping_)break;
+        lock.unlock();
+        if (msync(map_, map_size_, MS_SYNC) != 0)
+        {
+            NPULogger::instance().log("msync journal failed", errno, -1, -1, false);
+        }
+        lock.lock();
+    }
+}
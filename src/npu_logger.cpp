@@ -0,0 +1,171 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "npu_logger.h"
+
+namespace {
+
+const size_t LOG_QUEUE_CAPACITY = 4096;              //待处理日志上限
+const std::chrono::milliseconds POLL_INTERVAL(100);   //后台线程轮询间隔
+
+} // namespace
+
+bool NPULogger::Key::operator<(const Key& o) const
+{
+    if (msg != o.msg)return std::less<const char*>()(msg, o.msg);
+    if (ret != o.ret)return ret < o.ret;
+    if (card != o.card)return card < o.card;
+    return dev < o.dev;
+}
+
+NPULogger& NPULogger::instance()
+{
+    static NPULogger logger;
+    return logger;
+}
+
+NPULogger::NPULogger()
+    : queue_(LOG_QUEUE_CAPACITY), dropped_(0), dropped_reported_(0),
+      repeat_interval_(std::chrono::seconds(10)), max_lines_per_second_(20),
+      tokens_(20), last_refill_(std::chrono::steady_clock::now()), stopping_(false)
+{
+    thread_ = std::thread(&NPULogger::run, this);
+}
+
+NPULogger::~NPULogger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    flush();
+}
+
+void NPULogger::set_rate_limit(std::chrono::milliseconds repeat_interval, unsigned int max_lines_per_second)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    repeat_interval_ = repeat_interval;
+    max_lines_per_second_ = max_lines_per_second ? max_lines_per_second : 1;
+    tokens_ = max_lines_per_second_;
+}
+
+bool NPULogger::log(const char* msg, int ret, int card, int dev, bool fatal)
+{
+    NPULogEntry entry = {msg, ret, card, dev, fatal, false};
+    if (queue_.push(entry))return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool NPULogger::info(const char* msg, int card, int dev)
+{
+    NPULogEntry entry = {msg, 0, card, dev, false, true};
+    if (queue_.push(entry))return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void NPULogger::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    drain(true);
+    std::cerr.flush();
+}
+
+uint64_t NPULogger::dropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void NPULogger::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        drain(false);
+        cv_.wait_for(lock, POLL_INTERVAL, [this] { return stopping_; });
+    }
+}
+
+void NPULogger::drain(bool force)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    //聚合：相同键只累加计数
+    NPULogEntry entry;
+    while (queue_.pop(entry))
+    {
+        //通知按到达顺序逐条输出，不占错误日志的令牌
+        if (entry.info)
+        {
+            print_info(entry);
+            continue;
+        }
+        Key key = {entry.msg, entry.ret, entry.card, entry.dev};
+        auto it = states_.find(key);
+        if (it == states_.end())
+        {
+            State state = {entry.fatal, 0, false, now};
+            it = states_.insert(std::make_pair(key, state)).first;
+        }
+        it->second.pending++;
+        it->second.fatal = it->second.fatal || entry.fatal;
+    }
+
+    //令牌桶：每秒补充max_lines_per_second_行
+    double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+    last_refill_ = now;
+    tokens_ += elapsed * max_lines_per_second_;
+    if (tokens_ > max_lines_per_second_)tokens_ = max_lines_per_second_;
+
+    for (auto& kv : states_)
+    {
+        State& state = kv.second;
+        if (state.pending == 0)continue;
+        //已输出过的键，在repeat_interval内不重复输出
+        if (!force && state.printed && now - state.last_print < repeat_interval_)continue;
+        if (!force)
+        {
+            if (tokens_ < 1.0)break;
+            tokens_ -= 1.0;
+        }
+        print(kv.first, state);
+        state.pending = 0;
+        state.printed = true;
+        state.last_print = now;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != dropped_reported_)
+    {
+        std::cerr << "[WARNING] log queue full, dropped " << (dropped - dropped_reported_) << " message(s)\n";
+        dropped_reported_ = dropped;
+    }
+}
+
+void NPULogger::print(const Key& key, const State& state)
+{
+    std::string out;
+    out += state.fatal ? "[FATAL] " : "[WARNING] ";
+    out += key.msg;
+    out += "(ret=" + std::to_string(key.ret)+") ";
+    if (key.card >= 0)out += "(card=" + std::to_string(key.card)+") ";
+    if (key.dev >= 0)out += "(dev=" + std::to_string(key.dev)+") ";
+    if (state.printed || state.pending > 1)out += "(repeated " + std::to_string(state.pending) + " times) ";
+    out += '\n';
+    std::cerr << out;
+}
+
+void NPULogger::print_info(const NPULogEntry& entry)
+{
+    std::string out = "[INFO] ";
+    out += entry.msg;
+    out += ' ';
+    if (entry.card >= 0)out += "(card=" + std::to_string(entry.card)+") ";
+    if (entry.dev >= 0)out += "(dev=" + std::to_string(entry.dev)+") ";
+    out += '\n';
+    std::cerr << out;
+}
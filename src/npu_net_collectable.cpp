@@ -0,0 +1,83 @@
+#include <string>
+
+#include "npu_net_collectable.h"
+
+namespace {
+
+const struct
+{
+    const char* name;
+    const char* help;
+} NET_RATES[NPU_NET_RATE_NUM] = {
+#define NPU_NET_RATE_DESC(id, field, name, help) {name, help},
+    NPU_NET_RATE_LIST(NPU_NET_RATE_DESC)
+#undef NPU_NET_RATE_DESC
+};
+
+} // namespace
+
+NPUNetCollectable::NPUNetCollectable(const NPUNetSampler& sampler)
+    : sampler_(sampler)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUNetCollectable::Collect() const
+{
+    std::vector<NPUNetDevice> devices;
+    sampler_.snapshot(devices);
+
+    //最后一个为PFC暂停占比
+    std::vector<prometheus::MetricFamily> families(NPU_NET_RATE_NUM + 1);
+    for (int r = 0; r < NPU_NET_RATE_NUM; r++)
+    {
+        families[r].name = NET_RATES[r].name;
+        families[r].help = NET_RATES[r].help;
+        families[r].type = prometheus::MetricType::Gauge;
+    }
+    prometheus::MetricFamily& pause = families[NPU_NET_RATE_NUM];
+    pause.name = "npu_roce_pfc_pause_ratio";
+    pause.help = "Fraction of the last sampling interval the NPU spent in PFC pause, per direction and priority";
+    pause.type = prometheus::MetricType::Gauge;
+
+    for (const NPUNetDevice& d : devices)
+    {
+        std::vector<prometheus::ClientMetric::Label> label(3);
+        label[0].name = "card_id";
+        label[0].value = std::to_string(d.card_id);
+        label[1].name = "device_id";
+        label[1].value = std::to_string(d.device_id);
+
+        prometheus::ClientMetric m;
+        label[2].name = "port";
+        for (const NPUNetPortRates& port : d.ports)
+        {
+            if (!port.valid)continue;
+            label[2].value = std::to_string(port.port_id);
+            m.label = label;
+            for (int r = 0; r < NPU_NET_RATE_NUM; r++)
+            {
+                m.gauge.value = port.rates[r];
+                families[r].metric.push_back(m);
+            }
+        }
+
+        if (!d.pfc_valid)continue;
+        label[2].name = "direction";
+        label.resize(4);
+        label[3].name = "priority";
+        for (int p = 0; p < NPU_NET_PRIORITY_NUM; p++)
+        {
+            if (!(d.pfc_priority_mask & (1u << p)))continue;
+            label[3].value = std::to_string(p);
+            label[2].value = "tx";
+            m.label = label;
+            m.gauge.value = d.tx_pause_ratio[p];
+            pause.metric.push_back(m);
+            label[2].value = "rx";
+            m.label = label;
+            m.gauge.value = d.rx_pause_ratio[p];
+            pause.metric.push_back(m);
+        }
+    }
+    return families;
+}
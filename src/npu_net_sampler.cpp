@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "npu_net_sampler.h"
+#include "npu_logger.h"
+#include "dcmi_interface_api.h"
+
+#define NPU_OK (0)
+
+static_assert(NPU_NET_PRIORITY_NUM == PRIORITY_NUM, "priority count must match the DCMI header");
+
+namespace {
+
+/*按速率编号取出累计计数*/
+void read_counters(const dcmi_network_pkt_stats_info& info, uint64_t (&counters)[NPU_NET_RATE_NUM])
+{
+#define NPU_NET_RATE_READ(id, field, name, help) counters[NPU_NET_RATE_##id] = info.field;
+    NPU_NET_RATE_LIST(NPU_NET_RATE_READ)
+#undef NPU_NET_RATE_READ
+}
+
+double seconds_between(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration<double>(to - from).count();
+}
+
+} // namespace
+
+NPUNetSampler::NPUNetSampler(std::chrono::milliseconds interval, std::chrono::milliseconds enumerate_retry)
+    : interval_(interval), enumerate_retry_(enumerate_retry), pending_(false), running_(false)
+{
+}
+
+NPUNetSampler::~NPUNetSampler()
+{
+    stop();
+}
+
+void NPUNetSampler::set_devices(const std::vector<NPULabel>& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_labels_ = labels;
+    pending_ = true;
+}
+
+void NPUNetSampler::start()
+{
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    if (running_)return;
+    running_ = true;
+    thread_ = std::thread(&NPUNetSampler::run, this);
+}
+
+void NPUNetSampler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (!running_)return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())thread_.join();
+}
+
+void NPUNetSampler::snapshot(std::vector<NPUNetDevice>& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out = published_;
+}
+
+void NPUNetSampler::apply_devices()
+{
+    std::vector<NPULabel> labels;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pending_)return;
+        labels.swap(pending_labels_);
+        pending_ = false;
+    }
+
+    std::map<std::pair<int, int>, std::unique_ptr<Device>> old;
+    for (auto& d : devices_)old[std::make_pair(d->label.card_id, d->label.device_id)] = std::move(d);
+
+    devices_.clear();
+    for (const NPULabel& label : labels)
+    {
+        auto it = old.find(std::make_pair(label.card_id, label.device_id));
+        if (it != old.end() && it->second)
+        {
+            devices_.push_back(std::move(it->second));
+            continue;
+        }
+        std::unique_ptr<Device> d(new Device()); //值初始化：未枚举、无读数
+        d->label = label;
+        d->enumerate_next = std::chrono::steady_clock::time_point::min();
+        d->result.card_id = label.card_id;
+        d->result.device_id = label.device_id;
+        devices_.push_back(std::move(d));
+    }
+}
+
+void NPUNetSampler::enumerate_ports(Device& device, std::chrono::steady_clock::time_point now)
+{
+    //端口号不一定连续，逐个探测；读取成功的即为存在的端口，本次读数作为首个计数
+    device.ports.clear();
+    for (int p = 0; p < NPU_NET_MAX_PORT_NUM; p++)
+    {
+        struct dcmi_network_pkt_stats_info info;
+        std::memset(&info, 0, sizeof(info));
+        if (dcmi_get_netdev_pkt_stats_info(device.label.card_id, device.label.device_id, p, &info) != NPU_OK)continue;
+        Port port;
+        port.port_id = p;
+        port.has_last = true;
+        read_counters(info, port.last);
+        port.last_time = now;
+        device.ports.push_back(port);
+    }
+    device.enumerated = !device.ports.empty();
+    device.enumerate_next = now + enumerate_retry_;
+}
+
+void NPUNetSampler::sample_device(Device& device)
+{
+    int card = device.label.card_id;
+    int dev = device.label.device_id;
+    NPUNetDevice& result = device.result;
+    auto now = std::chrono::steady_clock::now();
+
+    /*端口速率*/
+    bool enumerated_now = false;
+    if (!device.enumerated && now >= device.enumerate_next)
+    {
+        enumerate_ports(device, now);
+        enumerated_now = true;
+    }
+    result.ports.resize(device.ports.size());
+    bool port_failed = false;
+    for (size_t i = 0; i < device.ports.size(); i++)
+    {
+        Port& port = device.ports[i];
+        NPUNetPortRates& rates = result.ports[i];
+        rates.port_id = port.port_id;
+        rates.valid = false;
+        if (enumerated_now)continue; //探测时的读数即首个计数，下次起才有速率
+
+        struct dcmi_network_pkt_stats_info info;
+        std::memset(&info, 0, sizeof(info));
+        int ret = dcmi_get_netdev_pkt_stats_info(card, dev, port.port_id, &info);
+        auto t = std::chrono::steady_clock::now();
+        if (ret != NPU_OK)
+        {
+            NPULogger::instance().log("get RoCE port statistics failed", ret, card, dev, false);
+            port_failed = true;
+            continue;
+        }
+        uint64_t counters[NPU_NET_RATE_NUM];
+        read_counters(info, counters);
+        double elapsed = seconds_between(port.last_time, t);
+        //计数回绕或被清零时本次不计算速率
+        bool monotonic = true;
+        for (int r = 0; r < NPU_NET_RATE_NUM; r++)if (counters[r] < port.last[r])monotonic = false;
+        if (port.has_last && monotonic && elapsed > 0)
+        {
+            for (int r = 0; r < NPU_NET_RATE_NUM; r++)rates.rates[r] = (double)(counters[r] - port.last[r]) / elapsed;
+            rates.valid = true;
+        }
+        std::memcpy(port.last, counters, sizeof(counters));
+        port.last_time = t;
+        port.has_last = true;
+    }
+    //端口读取失败（端口被禁用、设备复位等）时丢弃缓存，到期后重新探测
+    if (port_failed)
+    {
+        device.enumerated = false;
+        device.ports.clear();
+        result.ports.clear();
+    }
+
+    /*PFC暂停时长（按设备，单位us）*/
+    struct dcmi_pfc_duration_info pfc;
+    std::memset(&pfc, 0, sizeof(pfc));
+    int ret = dcmi_get_pfc_duration_info(card, dev, &pfc);
+    auto t = std::chrono::steady_clock::now();
+    result.pfc_valid = false;
+    if (ret != NPU_OK)
+    {
+        //不支持PFC统计的设备（如无RoCE端口）不记错误
+        if (!device.ports.empty())NPULogger::instance().log("get PFC duration failed", ret, card, dev, false);
+        device.pfc_has_last = false;
+        return;
+    }
+    double elapsed_us = seconds_between(device.pfc_last_time, t) * 1e6;
+    if (device.pfc_has_last && elapsed_us > 0)
+    {
+        result.pfc_valid = true;
+        for (int p = 0; p < NPU_NET_PRIORITY_NUM; p++)
+        {
+            if (pfc.tx[p] < device.pfc_last_tx[p] || pfc.rx[p] < device.pfc_last_rx[p])
+            {
+                result.pfc_valid = false;
+                break;
+            }
+            result.tx_pause_ratio[p] = std::min(1.0, (double)(pfc.tx[p] - device.pfc_last_tx[p]) / elapsed_us);
+            result.rx_pause_ratio[p] = std::min(1.0, (double)(pfc.rx[p] - device.pfc_last_rx[p]) / elapsed_us);
+            if (result.tx_pause_ratio[p] > 0 || result.rx_pause_ratio[p] > 0)result.pfc_priority_mask |= 1u << p;
+        }
+    }
+    std::memcpy(device.pfc_last_tx, pfc.tx, sizeof(device.pfc_last_tx));
+    std::memcpy(device.pfc_last_rx, pfc.rx, sizeof(device.pfc_last_rx));
+    device.pfc_last_time = t;
+    device.pfc_has_last = true;
+}
+
+void NPUNetSampler::sample_once()
+{
+    apply_devices();
+    for (auto& d : devices_)sample_device(*d);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_.resize(devices_.size());
+    for (size_t i = 0; i < devices_.size(); i++)published_[i] = devices_[i]->result;
+}
+
+void NPUNetSampler::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    while (running_)
+    {
+        lock.unlock();
+        sample_once();
+        lock.lock();
+
+        next += interval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now)next = now;
+        cv_.wait_until(lock, next, [this] { return !running_; });
+    }
+}
@@ -0,0 +1,72 @@
+#include <string>
+
+#include "npu_pcie_collectable.h"
+
+namespace {
+
+const struct
+{
+    const char* name;
+    const char* help;
+} PCIE_FIELDS[NPU_PCIE_FIELD_NUM] = {
+#define NPU_PCIE_FIELD_DESC(field, name, help) {name, help},
+    NPU_PCIE_FIELD_LIST(NPU_PCIE_FIELD_DESC)
+#undef NPU_PCIE_FIELD_DESC
+};
+
+const char* const PCIE_STATS[NPU_PCIE_STAT_NUM] = {"min", "max", "avg"};
+
+} // namespace
+
+NPUPcieCollectable::NPUPcieCollectable(const NPUPcieProfiler& profiler)
+    : profiler_(profiler)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUPcieCollectable::Collect() const
+{
+    std::vector<NPUPcieLink> links;
+    profiler_.snapshot(links);
+
+    //最后一个为窗口时间戳
+    std::vector<prometheus::MetricFamily> families(NPU_PCIE_FIELD_NUM + 1);
+    for (int f = 0; f < NPU_PCIE_FIELD_NUM; f++)
+    {
+        families[f].name = PCIE_FIELDS[f].name;
+        families[f].help = PCIE_FIELDS[f].help;
+        families[f].type = prometheus::MetricType::Gauge;
+    }
+    prometheus::MetricFamily& timestamp = families[NPU_PCIE_FIELD_NUM];
+    timestamp.name = "npu_pcie_window_timestamp_seconds";
+    timestamp.help = "End of the last successful NPU PCIe profiling window as a Unix timestamp";
+    timestamp.type = prometheus::MetricType::Gauge;
+
+    for (const NPUPcieLink& l : links)
+    {
+        if (l.timestamp_ms == 0)continue;
+        std::vector<prometheus::ClientMetric::Label> label(2);
+        label[0].name = "card_id";
+        label[0].value = std::to_string(l.card_id);
+        label[1].name = "device_id";
+        label[1].value = std::to_string(l.device_id);
+
+        prometheus::ClientMetric m;
+        m.label = label;
+        m.gauge.value = (double)l.timestamp_ms / 1000.0;
+        timestamp.metric.push_back(m);
+        if (!l.valid)continue;
+
+        m.label.resize(3);
+        m.label[2].name = "stat";
+        for (int s = 0; s < NPU_PCIE_STAT_NUM; s++)
+        {
+            m.label[2].value = PCIE_STATS[s];
+            for (int f = 0; f < NPU_PCIE_FIELD_NUM; f++)
+            {
+                m.gauge.value = (double)l.values[f][s];
+                families[f].metric.push_back(m);
+            }
+        }
+    }
+    return families;
+}
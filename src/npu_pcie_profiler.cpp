@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "npu_pcie_profiler.h"
+#include "npu_logger.h"
+#include "dcmi_interface_api.h"
+
+#define NPU_OK (0)
+
+static_assert(NPU_PCIE_STAT_NUM == AGENTDRV_PROF_DATA_NUM, "stat count must match the DCMI header");
+
+NPUPcieProfiler::NPUPcieProfiler(std::chrono::milliseconds window, std::chrono::milliseconds interval)
+    : window_(window), interval_(interval), pending_(false), job_seq_(0), measure_seq_(0), done_(0),
+      pool_(new NPUWorkerPool(1)), running_(false)
+{
+    job_label_ = NPULabel();
+    result_ = NPUPcieLink();
+    task_ = [this](size_t) { measure_job(); };
+}
+
+NPUPcieProfiler::~NPUPcieProfiler()
+{
+    stop();
+}
+
+void NPUPcieProfiler::set_devices(const std::vector<NPULabel>& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_labels_ = labels;
+    pending_ = true;
+}
+
+void NPUPcieProfiler::start()
+{
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    if (running_)return;
+    running_ = true;
+    thread_ = std::thread(&NPUPcieProfiler::run, this);
+}
+
+void NPUPcieProfiler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (!running_)return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())thread_.join();
+}
+
+void NPUPcieProfiler::snapshot(std::vector<NPUPcieLink>& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out = links_;
+}
+
+size_t NPUPcieProfiler::apply_devices()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_)return links_.size();
+
+    std::map<std::pair<int, int>, NPUPcieLink> old;
+    for (const NPUPcieLink& l : links_)old[std::make_pair(l.card_id, l.device_id)] = l;
+
+    links_.assign(pending_labels_.size(), NPUPcieLink());
+    for (size_t i = 0; i < links_.size(); i++)
+    {
+        auto it = old.find(std::make_pair(pending_labels_[i].card_id, pending_labels_[i].device_id));
+        if (it != old.end())links_[i] = it->second;
+        links_[i].card_id = pending_labels_[i].card_id;
+        links_[i].device_id = pending_labels_[i].device_id;
+    }
+    pending_ = false;
+    return links_.size();
+}
+
+void NPUPcieProfiler::measure(size_t index)
+{
+    //设备集只在本线程上切换，读取标签无需加锁
+    int card = links_[index].card_id;
+    int device = links_[index].device_id;
+
+    //工作线程仍卡在之前的调用中时不再分发，本设备直接记为失败
+    bool done = false;
+    if (pool_->idle())
+    {
+        uint64_t seq = ++measure_seq_;
+        job_label_.card_id = card;
+        job_label_.device_id = device;
+        job_seq_.store(seq, std::memory_order_release);
+        //驱动在窗口结束后返回；超过窗口长度加宽限（至少1秒）仍未返回时本窗口记为失败
+        auto grace = std::max<std::chrono::steady_clock::duration>(window_, std::chrono::seconds(1));
+        pool_->run_until(task_, std::chrono::steady_clock::now() + window_ + grace);
+        done = done_.load(std::memory_order_acquire) == seq;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    NPUPcieLink& l = links_[index];
+    if (!done || !result_.valid)
+    {
+        l.valid = false;
+        return;
+    }
+    l.valid = true;
+    l.timestamp_ms = result_.timestamp_ms;
+    std::memcpy(l.values, result_.values, sizeof(l.values));
+}
+
+void NPUPcieProfiler::measure_job()
+{
+    uint64_t seq = job_seq_.load(std::memory_order_acquire);
+    int card = job_label_.card_id;
+    int device = job_label_.device_id;
+
+    struct dcmi_pcie_link_bandwidth_info info;
+    std::memset(&info, 0, sizeof(info));
+    info.profiling_time = (int)window_.count();
+    int ret = dcmi_get_pcie_link_bandwidth_info(card, device, &info);
+    result_.valid = ret == NPU_OK;
+    if (ret != NPU_OK)NPULogger::instance().log("get PCIe link bandwidth failed", ret, card, device, false);
+    else
+    {
+        result_.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+#define NPU_PCIE_FIELD_COPY(field, name, help) \
+        std::memcpy(result_.values[NPU_PCIE_##field], info.field, sizeof(result_.values[NPU_PCIE_##field]));
+        NPU_PCIE_FIELD_LIST(NPU_PCIE_FIELD_COPY)
+#undef NPU_PCIE_FIELD_COPY
+    }
+    done_.store(seq, std::memory_order_release);
+}
+
+void NPUPcieProfiler::profile_once()
+{
+    size_t n = apply_devices();
+    for (size_t i = 0; i < n; i++)measure(i);
+}
+
+bool NPUPcieProfiler::wait_until(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    cv_.wait_until(lock, deadline, [this] { return !running_; });
+    return running_;
+}
+
+void NPUPcieProfiler::run()
+{
+    auto round_start = std::chrono::steady_clock::now();
+    while (true)
+    {
+        //每轮开始时切换设备集，各设备的窗口在interval内均匀错开
+        size_t n = apply_devices();
+        std::chrono::steady_clock::duration spacing = interval_;
+        if (n > 0)spacing = std::max<std::chrono::steady_clock::duration>(interval_ / n, window_);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!wait_until(round_start + spacing * i))return;
+            measure(i);
+        }
+
+        //驱动调用比预期慢时从当前时刻重新排，不补测
+        round_start += std::max<std::chrono::steady_clock::duration>(interval_, spacing * n);
+        auto now = std::chrono::steady_clock::now();
+        if (round_start < now)round_start = now;
+        if (!wait_until(round_start))return;
+    }
+}
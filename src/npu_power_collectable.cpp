@@ -0,0 +1,77 @@
+#include <string>
+
+#include "npu_power_collectable.h"
+
+namespace {
+
+/*窗口统计的各导出项*/
+enum PowerFamily
+{
+    POWER_MIN,
+    POWER_MAX,
+    POWER_MEAN,
+    POWER_P99,
+    POWER_SAMPLES,
+    POWER_ENERGY,
+    POWER_FAMILY_NUM
+};
+
+const struct
+{
+    const char* name;
+    const char* help;
+    prometheus::MetricType type;
+} POWER_FAMILIES[POWER_FAMILY_NUM] = {
+    {"npu_power_window_min_watts", "Minimum NPU power over the last completed window in watts", prometheus::MetricType::Gauge},
+    {"npu_power_window_max_watts", "Maximum NPU power over the last completed window in watts", prometheus::MetricType::Gauge},
+    {"npu_power_window_mean_watts", "Mean NPU power over the last completed window in watts", prometheus::MetricType::Gauge},
+    {"npu_power_window_p99_watts", "99th percentile of NPU power over the last completed window in watts", prometheus::MetricType::Gauge},
+    {"npu_power_window_samples", "Number of high-rate NPU power readings in the last completed window", prometheus::MetricType::Gauge},
+    {"npu_energy_joules_total", "NPU energy consumed since the device was first sampled in joules", prometheus::MetricType::Counter},
+};
+
+} // namespace
+
+NPUPowerCollectable::NPUPowerCollectable(const NPUPowerSampler& sampler)
+    : sampler_(sampler)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUPowerCollectable::Collect() const
+{
+    std::vector<NPUPowerWindow> windows;
+    sampler_.windows(windows);
+
+    std::vector<prometheus::MetricFamily> families(POWER_FAMILY_NUM);
+    for (int f = 0; f < POWER_FAMILY_NUM; f++)
+    {
+        families[f].name = POWER_FAMILIES[f].name;
+        families[f].help = POWER_FAMILIES[f].help;
+        families[f].type = POWER_FAMILIES[f].type;
+        families[f].metric.reserve(windows.size());
+    }
+
+    for (const NPUPowerWindow& w : windows)
+    {
+        std::vector<prometheus::ClientMetric::Label> label(2);
+        label[0].name = "card_id";
+        label[0].value = std::to_string(w.card_id);
+        label[1].name = "device_id";
+        label[1].value = std::to_string(w.device_id);
+
+        double values[POWER_FAMILY_NUM] = {
+            w.min_watts, w.max_watts, w.mean_watts, w.p99_watts, (double)w.samples, w.energy_joules
+        };
+        for (int f = 0; f < POWER_FAMILY_NUM; f++)
+        {
+            //窗口内没有读数时只导出读数与能耗
+            if (w.samples == 0 && f < POWER_SAMPLES)continue;
+            prometheus::ClientMetric m;
+            m.label = label;
+            if (POWER_FAMILIES[f].type == prometheus::MetricType::Counter)m.counter.value = values[f];
+            else m.gauge.value = values[f];
+            families[f].metric.push_back(m);
+        }
+    }
+    return families;
+}
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "npu_power_sampler.h"
+#include "npu_logger.h"
+#include "dcmi_interface_api.h"
+
+#define NPU_OK (0)
+
+NPUPowerSampler::NPUPowerSampler(unsigned int hz, std::chrono::milliseconds window)
+    : hz_(hz ? hz : 1), period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::seconds(1)) / (hz ? hz : 1)),
+      window_(window), pending_(false), running_(false)
+{
+    rotate_values_.reserve(NPU_POWER_WINDOW_SAMPLES);
+}
+
+NPUPowerSampler::~NPUPowerSampler()
+{
+    stop();
+}
+
+void NPUPowerSampler::set_devices(const std::vector<NPULabel>& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_labels_ = labels;
+    pending_ = true;
+}
+
+void NPUPowerSampler::start()
+{
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    if (running_)return;
+    running_ = true;
+    thread_ = std::thread(&NPUPowerSampler::run, this);
+}
+
+void NPUPowerSampler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (!running_)return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())thread_.join();
+}
+
+unsigned int NPUPowerSampler::rate() const
+{
+    return hz_;
+}
+
+std::chrono::milliseconds NPUPowerSampler::window() const
+{
+    return window_;
+}
+
+void NPUPowerSampler::apply_devices()
+{
+    std::map<std::pair<int, int>, std::unique_ptr<Device>> old;
+    for (auto& d : devices_)old[std::make_pair(d->label.card_id, d->label.device_id)] = std::move(d);
+
+    devices_.clear();
+    for (const NPULabel& label : pending_labels_)
+    {
+        auto it = old.find(std::make_pair(label.card_id, label.device_id));
+        if (it != old.end() && it->second)
+        {
+            devices_.push_back(std::move(it->second));
+            continue;
+        }
+        std::unique_ptr<Device> d(new Device()); //值初始化：读数与累计清零
+        d->label = label;
+        d->min = UINT16_MAX;
+        d->has_last = false;
+        devices_.push_back(std::move(d));
+    }
+    pending_ = false;
+}
+
+void NPUPowerSampler::sample_once()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_)apply_devices();
+        tick_labels_.resize(devices_.size());
+        for (size_t i = 0; i < devices_.size(); i++)tick_labels_[i] = devices_[i]->label;
+    }
+    tick_power_.resize(tick_labels_.size());
+    tick_time_.resize(tick_labels_.size());
+
+    //驱动调用不持锁；设备集只在本线程切换，两次加锁之间devices_不变
+    for (size_t i = 0; i < tick_labels_.size(); i++)
+    {
+        int power = 0;
+        int ret = dcmi_get_device_power_info(tick_labels_[i].card_id, tick_labels_[i].device_id, &power);
+        if (ret != NPU_OK)
+        {
+            NPULogger::instance().log("get high-rate power failed", ret, tick_labels_[i].card_id, tick_labels_[i].device_id, false);
+            power = -1;
+        }
+        tick_power_[i] = power;
+        tick_time_[i] = std::chrono::steady_clock::now();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < tick_labels_.size(); i++)
+    {
+        Device& d = *devices_[i];
+        if (tick_power_[i] < 0)
+        {
+            //读取失败：不知道中断期间的功耗，不跨过中断积分，恢复后从下一次读数重新开始
+            d.has_last = false;
+            continue;
+        }
+        uint16_t v = (uint16_t)std::min(tick_power_[i], (int)UINT16_MAX); //单位0.1W
+
+        d.ring[d.count % NPU_POWER_WINDOW_SAMPLES] = v;
+        d.count++;
+        d.sum += v;
+        if (v < d.min)d.min = v;
+        if (v > d.max)d.max = v;
+
+        //梯形积分：两次读数之间按线性变化计
+        if (d.has_last)
+        {
+            double dt = std::chrono::duration<double>(tick_time_[i] - d.last_time).count();
+            d.energy_joules += (d.last + v) / 2.0 / 10.0 * dt;
+        }
+        d.has_last = true;
+        d.last = v;
+        d.last_time = tick_time_[i];
+    }
+}
+
+void NPUPowerSampler::rotate_windows()
+{
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::vector<NPUPowerWindow> out;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t n = devices_.size();
+    out.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        //逐设备持锁拷出并清零窗口，排序在锁外进行，不阻塞读者；设备集只在采样线程上切换
+        if (!lock.owns_lock())lock.lock();
+        Device& d = *devices_[i];
+        NPUPowerWindow& w = out[i];
+        w.card_id = d.label.card_id;
+        w.device_id = d.label.device_id;
+        w.timestamp_ms = now_ms;
+        w.samples = d.count;
+        w.energy_joules = d.energy_joules;
+        w.min_watts = d.count ? d.min / 10.0 : 0.0;
+        w.max_watts = d.count ? d.max / 10.0 : 0.0;
+        w.mean_watts = d.count ? (double)d.sum / d.count / 10.0 : 0.0;
+        uint32_t kept = std::min<uint32_t>(d.count, NPU_POWER_WINDOW_SAMPLES);
+        rotate_values_.assign(d.ring, d.ring + kept);
+        d.count = 0;
+        d.sum = 0;
+        d.min = UINT16_MAX;
+        d.max = 0;
+        lock.unlock();
+
+        w.p99_watts = 0.0;
+        if (!rotate_values_.empty())
+        {
+            size_t k = (rotate_values_.size() * 99) / 100;
+            if (k >= rotate_values_.size())k = rotate_values_.size() - 1;
+            std::nth_element(rotate_values_.begin(), rotate_values_.begin() + k, rotate_values_.end());
+            w.p99_watts = rotate_values_[k] / 10.0;
+        }
+    }
+
+    if (!lock.owns_lock())lock.lock();
+    completed_.swap(out);
+}
+
+void NPUPowerSampler::windows(std::vector<NPUPowerWindow>& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out = completed_;
+}
+
+void NPUPowerSampler::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    auto window_end = next + window_;
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    while (running_)
+    {
+        lock.unlock();
+        sample_once();
+        //窗口按固定节拍轮转，与抓取无关；落后超过一个窗口时从当前时刻重新计时
+        auto now = std::chrono::steady_clock::now();
+        if (now >= window_end)
+        {
+            rotate_windows();
+            window_end += window_;
+            if (window_end <= now)window_end = now + window_;
+        }
+        lock.lock();
+
+        next += period_;
+        now = std::chrono::steady_clock::now();
+        if (next < now)next = now; //一轮超时则不补采
+        cv_.wait_until(lock, next, [this] { return !running_; });
+    }
+}
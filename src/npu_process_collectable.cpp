@@ -0,0 +1,56 @@
+#include <string>
+
+#include "npu_process_collectable.h"
+
+NPUProcessCollectable::NPUProcessCollectable(const NPUProcessSampler& sampler)
+    : sampler_(sampler)
+{
+}
+
+std::vector<prometheus::MetricFamily> NPUProcessCollectable::Collect() const
+{
+    std::vector<NPUProcessDevice> devices;
+    sampler_.snapshot(devices);
+
+    std::vector<prometheus::MetricFamily> families(3);
+    prometheus::MetricFamily& top = families[0];
+    top.name = "npu_process_memory_bytes";
+    top.help = "NPU device memory used by a process, for the processes using the most memory on the device";
+    top.type = prometheus::MetricType::Gauge;
+    prometheus::MetricFamily& other = families[1];
+    other.name = "npu_process_memory_other_bytes";
+    other.help = "NPU device memory used by all processes not exported individually";
+    other.type = prometheus::MetricType::Gauge;
+    prometheus::MetricFamily& count = families[2];
+    count.name = "npu_process_count";
+    count.help = "Number of processes using the NPU device";
+    count.type = prometheus::MetricType::Gauge;
+
+    for (const NPUProcessDevice& d : devices)
+    {
+        if (!d.valid)continue;
+        std::vector<prometheus::ClientMetric::Label> label(2);
+        label[0].name = "card_id";
+        label[0].value = std::to_string(d.card_id);
+        label[1].name = "device_id";
+        label[1].value = std::to_string(d.device_id);
+
+        prometheus::ClientMetric m;
+        m.label = label;
+        m.gauge.value = (double)d.other_bytes;
+        other.metric.push_back(m);
+        m.gauge.value = (double)d.process_num;
+        count.metric.push_back(m);
+
+        label.resize(3);
+        label[2].name = "pid";
+        for (const NPUProcessMemory& p : d.top)
+        {
+            label[2].value = std::to_string(p.pid);
+            m.label = label;
+            m.gauge.value = (double)p.bytes;
+            top.metric.push_back(m);
+        }
+    }
+    return families;
+}
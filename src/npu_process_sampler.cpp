@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstring>
+
+#include "npu_process_sampler.h"
+#include "npu_logger.h"
+#include "dcmi_interface_api.h"
+
+#define NPU_OK (0)
+
+NPUProcessSampler::NPUProcessSampler(std::chrono::milliseconds interval, size_t top_k)
+    : interval_(interval), top_k_(top_k), running_(false)
+{
+    procs_.reserve(NPU_PROCESS_MAX_NUM);
+}
+
+NPUProcessSampler::~NPUProcessSampler()
+{
+    stop();
+}
+
+void NPUProcessSampler::set_devices(const std::vector<NPULabel>& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    labels_ = labels;
+}
+
+void NPUProcessSampler::start()
+{
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    if (running_)return;
+    running_ = true;
+    thread_ = std::thread(&NPUProcessSampler::run, this);
+}
+
+void NPUProcessSampler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (!running_)return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())thread_.join();
+}
+
+void NPUProcessSampler::snapshot(std::vector<NPUProcessDevice>& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out = published_;
+}
+
+size_t NPUProcessSampler::top_k() const
+{
+    return top_k_;
+}
+
+void NPUProcessSampler::sample_device(const NPULabel& label, NPUProcessDevice& out)
+{
+    out.card_id = label.card_id;
+    out.device_id = label.device_id;
+    out.valid = false;
+    out.top.clear();
+    out.process_num = 0;
+    out.other_num = 0;
+    out.other_bytes = 0;
+
+    struct dcmi_proc_mem_info info[NPU_PROCESS_MAX_NUM];
+    std::memset(info, 0, sizeof(info));
+    int num = NPU_PROCESS_MAX_NUM;
+    int ret = dcmi_get_device_resource_info(label.card_id, label.device_id, info, &num);
+    if (ret != NPU_OK)
+    {
+        NPULogger::instance().log("get device process memory failed", ret, label.card_id, label.device_id, false);
+        return;
+    }
+    num = std::max(0, std::min(num, NPU_PROCESS_MAX_NUM));
+
+    procs_.resize(num);
+    for (int i = 0; i < num; i++)
+    {
+        procs_[i].pid = info[i].proc_id;
+        procs_[i].bytes = info[i].proc_mem_usage;
+    }
+    //占用相同时按pid排序，避免单列的进程在两次读取间来回切换
+    size_t k = std::min(top_k_, procs_.size());
+    std::partial_sort(procs_.begin(), procs_.begin() + k, procs_.end(),
+        [](const NPUProcessMemory& a, const NPUProcessMemory& b) {
+            return a.bytes != b.bytes ? a.bytes > b.bytes : a.pid < b.pid;
+        });
+    out.top.assign(procs_.begin(), procs_.begin() + k);
+    for (size_t i = k; i < procs_.size(); i++)out.other_bytes += procs_[i].bytes;
+    out.process_num = (uint32_t)procs_.size();
+    out.other_num = (uint32_t)(procs_.size() - k);
+    out.valid = true;
+}
+
+void NPUProcessSampler::sample_once()
+{
+    std::vector<NPULabel> labels;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        labels = labels_;
+    }
+    std::vector<NPUProcessDevice> devices(labels.size());
+    for (size_t i = 0; i < labels.size(); i++)sample_device(labels[i], devices[i]);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_.swap(devices);
+}
+
+void NPUProcessSampler::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    while (running_)
+    {
+        lock.unlock();
+        sample_once();
+        lock.lock();
+
+        next += interval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now)next = now;
+        cv_.wait_until(lock, next, [this] { return !running_; });
+    }
+}
@@ -0,0 +1,109 @@
+#include "npu_worker_pool.h"
+
+NPUWorkerPool::NPUWorkerPool(size_t workers, std::chrono::milliseconds stop_timeout)
+    : state_(std::make_shared<State>()), stop_timeout_(stop_timeout)
+{
+    state_->tasks.assign(workers, nullptr);
+    state_->job_round.assign(workers, 0);
+    state_->busy.assign(workers, false);
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; i++)
+    {
+        threads_.emplace_back(&NPUWorkerPool::worker_loop, state_, i);
+    }
+}
+
+NPUWorkerPool::~NPUWorkerPool()
+{
+    State& s = *state_;
+    std::vector<bool> stuck;
+    {
+        std::unique_lock<std::mutex> lock(s.mutex);
+        s.stopping = true;
+        s.start_cv.notify_all();
+        //空闲线程看到stopping即退出；仍在执行任务的线程最多等stop_timeout
+        s.done_cv.wait_for(lock, stop_timeout_, [&s] {
+            for (size_t i = 0; i < s.busy.size(); i++)
+            {
+                if (s.busy[i])return false;
+            }
+            return true;
+        });
+        stuck = s.busy;
+    }
+    for (size_t i = 0; i < threads_.size(); i++)
+    {
+        if (stuck[i])threads_[i].detach();
+        else threads_[i].join();
+    }
+}
+
+size_t NPUWorkerPool::size() const
+{
+    return threads_.size();
+}
+
+bool NPUWorkerPool::idle()
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    for (size_t i = 0; i < state_->busy.size(); i++)
+    {
+        if (state_->busy[i])return false;
+    }
+    return true;
+}
+
+void NPUWorkerPool::run(const std::function<void(size_t)>& task)
+{
+    run_until(task, std::chrono::steady_clock::time_point::max());
+}
+
+bool NPUWorkerPool::run_until(const std::function<void(size_t)>& task, std::chrono::steady_clock::time_point deadline)
+{
+    if (threads_.empty())return true;
+    State& s = *state_;
+    std::unique_lock<std::mutex> lock(s.mutex);
+    s.round++;
+    s.pending = 0;
+    for (size_t i = 0; i < threads_.size(); i++)
+    {
+        //上一轮超时仍在执行的线程本轮跳过
+        if (s.busy[i])continue;
+        s.busy[i] = true;
+        s.tasks[i] = &task;
+        s.job_round[i] = s.round;
+        s.pending++;
+    }
+    s.start_cv.notify_all();
+
+    if (deadline == std::chrono::steady_clock::time_point::max())
+    {
+        s.done_cv.wait(lock, [&s] { return s.pending == 0; });
+        return true;
+    }
+    return s.done_cv.wait_until(lock, deadline, [&s] { return s.pending == 0; });
+}
+
+void NPUWorkerPool::worker_loop(std::shared_ptr<State> state, size_t id)
+{
+    State& s = *state;
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (true)
+    {
+        s.start_cv.wait(lock, [&] { return s.stopping || s.job_round[id] != seen; });
+        if (s.stopping)return;
+        seen = s.job_round[id];
+        const std::function<void(size_t)>* task = s.tasks[id];
+
+        //执行任务时不持锁，各线程真正并发
+        lock.unlock();
+        (*task)(id);
+        lock.lock();
+
+        s.busy[id] = false;
+        //超时完成的旧任务不计入当前轮；析构时等待的是全部线程空闲
+        if (s.stopping)s.done_cv.notify_all();
+        else if (seen == s.round && --s.pending == 0)s.done_cv.notify_one();
+    }
+}
@@ -2,11 +2,27 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <cstring>
 #include <signal.h>
 #include <atomic>
 
 #include "npu_impl.h"
+#include "npu_sampler.h"
 #include "npu_collector.h"
+#include "npu_snapshot_collectable.h"
+#include "npu_node_collectable.h"
+#include "npu_exposition_cache.h"
+#include "npu_call_stats_collectable.h"
+#include "npu_fault_events_collectable.h"
+#include "npu_power_collectable.h"
+#include "npu_hccs_collectable.h"
+#include "npu_pcie_collectable.h"
+#include "npu_net_collectable.h"
+#include "npu_process_collectable.h"
+#include "npu_http_server.h"
+#include "npu_history.h"
+#include "npu_history_endpoint.h"
+#include "npu_journal.h"
 #include <prometheus/exposer.h>
 
 
@@ -17,17 +33,147 @@ void signalHandler(int signal) {
     running = false;
 }
 
-int main() {
+// 后台测量阶段：与核心采样分开，各自有线程和节拍
+struct Stages {
+    NPUPowerSampler& power;
+    NPUHccsProfiler& hccs;
+    NPUPcieProfiler& pcie;
+    NPUNetSampler& net;
+    NPUProcessSampler& process;
+};
+
+// 每个周期结束后：快照写入本地历史与日志，各测量阶段的设备集跟随快照（设备增减后随之调整）
+void on_cycle(const NPUSampler<NPUImpl>& sampler, Stages& stages,
+              NPUHistory& history, NPUJournal& journal, NPUSnapshot& snapshot) {
+    if (!sampler.snapshot(snapshot)) return;
+    history.append(snapshot.timestamp_ms, snapshot.labels, snapshot.metrics);
+    journal.append(snapshot.timestamp_ms, snapshot.labels, snapshot.metrics);
+    stages.power.set_devices(snapshot.labels);
+    stages.hccs.set_devices(snapshot.labels);
+    stages.pcie.set_devices(snapshot.labels);
+    stages.net.set_devices(snapshot.labels);
+    stages.process.set_devices(snapshot.labels);
+}
+
+// 预渲染模式：每个采样周期渲染一次/metrics，抓取直接返回缓存内容
+int run_cached(NPUImpl& npu_impl, NPUSampler<NPUImpl>& sampler, Stages& stages,
+               NPUHistory& history, NPUJournal& journal) {
+    auto collectable = std::make_shared<NPUSnapshotCollectable<NPUSampler<NPUImpl>>>(sampler);
+    auto call_stats = std::make_shared<NPUCallStatsCollectable>(npu_impl.dcmi_call_stats());
+    auto fault_events = std::make_shared<NPUFaultEventsCollectable>(NPUFaultEvents::instance());
+    auto power_windows = std::make_shared<NPUPowerCollectable>(stages.power);
+    auto node = std::make_shared<NPUNodeCollectable<NPUSampler<NPUImpl>>>(sampler);
+    auto hccs_bandwidth = std::make_shared<NPUHccsCollectable>(stages.hccs);
+    auto pcie_links = std::make_shared<NPUPcieCollectable>(stages.pcie);
+    auto roce = std::make_shared<NPUNetCollectable>(stages.net);
+    auto processes = std::make_shared<NPUProcessCollectable>(stages.process);
+    NPUExpositionCache cache;
+    cache.add_collectable(collectable);
+    cache.add_collectable(node);
+    cache.add_collectable(call_stats);
+    cache.add_collectable(fault_events);
+    cache.add_collectable(power_windows);
+    cache.add_collectable(hccs_bandwidth);
+    cache.add_collectable(pcie_links);
+    cache.add_collectable(roce);
+    cache.add_collectable(processes);
+    NPUSnapshot snapshot;
+    sampler.set_cycle_callback([&](uint64_t cycle) {
+        on_cycle(sampler, stages, history, journal, snapshot);
+        cache.render(cycle);
+    });
+    // 故障事件到达时重新渲染，不等下一个采样周期（事件风暴时合并，每100毫秒最多渲染一次）
+    NPUFaultEvents::instance().set_listener([&cache, &sampler](const NPUFaultEvent&) { cache.render(sampler.cycle()); });
+
+    NPUHttpServer server("0.0.0.0:8080");
+    cache.serve(server);
+    server.start();
+    // /history是可能持续较久的流式响应，使用单独的服务器与处理线程，不占用/metrics的线程
+    NPUHistoryEndpoint history_endpoint(history);
+    NPUHttpServer history_server("0.0.0.0:8081", 2, std::chrono::seconds(60));
+    history_endpoint.serve(history_server);
+    history_server.start();
+    sampler.start();
+    stages.power.start();
+    stages.hccs.start();
+    stages.pcie.start();
+    stages.net.start();
+    stages.process.start();
+
+    std::cout << "NPU监控已启动（预渲染模式），访问 http://localhost:8080/metrics 查看数据，"
+              << "http://localhost:8081/history 查询本地历史" << std::endl;
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    NPUFaultEvents::instance().set_listener(nullptr);
+    stages.process.stop();
+    stages.net.stop();
+    stages.pcie.stop();
+    stages.hccs.stop();
+    stages.power.stop();
+    sampler.stop();
+    history_server.stop();
+    server.stop();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     // 设置信号处理
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    // 参数：cached 使用预渲染模式；--journal=路径 启用崩溃安全的采样日志
+    bool cached = false;
+    std::string journal_path;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "cached") == 0) cached = true;
+        else if (std::strncmp(argv[i], "--journal=", 10) == 0) journal_path = argv[i] + 10;
+    }
     
     try {
-        // 1. 初始化NPU
-        NPUImpl npu_impl;
+        // 1. 初始化NPU，并创建后台采样器（驱动调用不再阻塞导出）
+        NPUImpl npu_impl(NPUSampleMode::PARALLEL);
+        // 每10秒检查一次设备增减（热插拔、卡复位），无需重启
+        npu_impl.set_rediscover_interval(std::chrono::seconds(10));
+        // 订阅驱动推送的故障事件；成功后健康状态轮询降为60秒一次的兜底
+        if (NPUFaultEvents::instance().subscribe()) {
+            npu_impl.set_group_interval(NPU_GROUP_HEALTH, std::chrono::seconds(60));
+        }
+        NPUSampler<NPUImpl> sampler(npu_impl, std::chrono::seconds(2));
+        // 100Hz功耗采样：按10秒的固定窗口导出min/max/mean/p99与累计能耗
+        NPUPowerSampler power(100, std::chrono::seconds(10));
+        // HCCS链路带宽：每10秒对全部设备同时测量1秒，不占用采样周期
+        NPUHccsProfiler hccs(std::chrono::seconds(1), std::chrono::seconds(10));
+        // PCIe带宽与时延：各设备的1秒测量窗口在60秒内错开，同一时刻只测一个设备
+        NPUPcieProfiler pcie(std::chrono::seconds(1), std::chrono::seconds(60));
+        // RoCE端口吞吐与PFC暂停占比：每5秒读取累计计数，按差值计算
+        NPUNetSampler net(std::chrono::seconds(5));
+        // 进程级内存：与采样周期一致，每设备单列占用最多的5个进程
+        NPUProcessSampler process(std::chrono::seconds(2), 5);
+        Stages stages{power, hccs, pcie, net, process};
+        // 本地压缩历史：Prometheus不可达时仍可查看最近几小时的数据
+        NPUHistory history;
+        // 采样日志：启动时先重放上次运行（包括崩溃前）的数据到本地历史
+        NPUJournal journal;
+        if (!journal_path.empty() && journal.open(journal_path)) {
+            size_t cycles = journal.replay([&history](int64_t ts, const std::vector<NPULabel>& labels,
+                                                      const std::vector<NPUMetric>& metrics) {
+                history.append(ts, labels, metrics);
+            });
+            std::cout << "从 " << journal_path << " 重放了 " << cycles << " 个采样周期" << std::endl;
+        }
+        if (cached) return run_cached(npu_impl, sampler, stages, history, journal);
+        NPUSnapshot snapshot;
+        sampler.set_cycle_callback([&](uint64_t) { on_cycle(sampler, stages, history, journal, snapshot); });
+        sampler.start();
+        power.start();
+        hccs.start();
+        pcie.start();
+        net.start();
+        process.start();
         
-        // 2. 创建收集器（自动注册指标）
-        NPUCollector<NPUImpl> collector(npu_impl);
+        // 2. 创建收集器（自动注册指标），数据来自采样器的最新快照
+        NPUSampler<NPUImpl>::Reader reader(sampler);
+        NPUCollector<NPUSampler<NPUImpl>::Reader> collector(reader);
         
         // 3. 启动HTTP服务器
         // 创建exposer
@@ -35,14 +181,45 @@ int main() {
 
         // 获取registry并设置给exposer
         exposer.RegisterCollectable(NPUCollector<NPUImpl>::GetRegistry());
+        // 导出器自监控：DCMI调用耗时
+        auto call_stats = std::make_shared<NPUCallStatsCollectable>(npu_impl.dcmi_call_stats());
+        exposer.RegisterCollectable(call_stats);
+        // 故障事件：抓取时直接读取最新统计
+        auto fault_events = std::make_shared<NPUFaultEventsCollectable>(NPUFaultEvents::instance());
+        exposer.RegisterCollectable(fault_events);
+        auto power_windows = std::make_shared<NPUPowerCollectable>(power);
+        exposer.RegisterCollectable(power_windows);
+        auto hccs_bandwidth = std::make_shared<NPUHccsCollectable>(hccs);
+        exposer.RegisterCollectable(hccs_bandwidth);
+        auto pcie_links = std::make_shared<NPUPcieCollectable>(pcie);
+        exposer.RegisterCollectable(pcie_links);
+        auto roce = std::make_shared<NPUNetCollectable>(net);
+        exposer.RegisterCollectable(roce);
+        auto processes = std::make_shared<NPUProcessCollectable>(process);
+        exposer.RegisterCollectable(processes);
+        // 节点级汇总：由采样器的列式读数计算，看板无需在查询时聚合各设备序列
+        auto node = std::make_shared<NPUNodeCollectable<NPUSampler<NPUImpl>>>(sampler);
+        exposer.RegisterCollectable(node);
+        // 本地历史查询：/history由自有HTTP服务提供（Exposer只能注册Collectable）
+        NPUHistoryEndpoint history_endpoint(history);
+        NPUHttpServer history_server("0.0.0.0:8081", 2, std::chrono::seconds(60));
+        history_endpoint.serve(history_server);
+        history_server.start();
         
-        std::cout << "NPU监控已启动，访问 http://localhost:8080/metrics 查看数据" << std::endl;
+        std::cout << "NPU监控已启动，访问 http://localhost:8080/metrics 查看数据，"
+                  << "http://localhost:8081/history 查询本地历史" << std::endl;
         
-        // 4. 定期采集
+        // 4. 定期把最新快照写入registry
         while (running) {
             collector.collect();
             std::this_thread::sleep_for(std::chrono::seconds(2));
         }
+        process.stop();
+        net.stop();
+        pcie.stop();
+        hccs.stop();
+        power.stop();
+        sampler.stop();
         
     } catch (const std::exception& e) {
         std::cerr << "错误: " << e.what() << std::endl;
@@ -50,4 +227,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,108 @@
+#include "npu_exposition_cache.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+/*向127.0.0.1:port发送GET /metrics（带给定的Accept-Encoding，为空时不带），返回响应头；失败时返回false*/
+bool get_headers(int port, const char* accept_encoding, std::string& headers)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)return false;
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    std::string req = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n";
+    if (accept_encoding != nullptr)req += std::string("Accept-Encoding: ") + accept_encoding + "\r\n";
+    req += "\r\n";
+    if (send(fd, req.data(), req.size(), 0) != (ssize_t)req.size())
+    {
+        close(fd);
+        return false;
+    }
+    //服务器处理一个请求后关闭连接，读到EOF为止
+    std::string raw;
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)raw.append(buf, (size_t)n);
+    close(fd);
+
+    size_t pos = raw.find("\r\n\r\n");
+    if (raw.compare(0, 12, "HTTP/1.1 200") != 0 || pos == std::string::npos)return false;
+    headers = raw.substr(0, pos + 2);
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    std::cout << "=== NPU Exposition Cache Test ===" << std::endl;
+
+    //没有Collectable时正文为空，gzip结果仍非空，足以检查内容协商
+    NPUExpositionCache cache;
+    cache.render(1);
+    NPUHttpServer server("127.0.0.1:0", 1);
+    cache.serve(server);
+    server.start();
+
+    std::cout << "\n--- Accept-Encoding ---" << std::endl;
+    struct Case
+    {
+        const char* accept_encoding;
+        bool gzip;
+    };
+    const Case cases[] = {
+        {nullptr, false},
+        {"", false},
+        {"gzip", true},
+        {"GZIP", true},
+        {"deflate, gzip;q=0.5", true},
+        {"gzip ; q=1.0, identity", true},
+        {"gzip;q=0", false},
+        {"gzip; q=0.000", false},
+        {"gzip;q=0, *", false},       //显式拒绝优先于"*"
+        {"*", true},
+        {"*;q=0", false},
+        {"*;q=0, gzip;q=0.1", true},
+        {"identity, deflate", false},
+        {"gzipx, xgzip", false},
+        {"x-gzip", true},
+        {"br;q=1.0,\tgzip;q=0.8", true},
+    };
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        std::string headers;
+        if (!get_headers(server.port(), cases[i].accept_encoding, headers))
+        {
+            std::cerr << "Request " << i << " failed" << std::endl;
+            return 1;
+        }
+        bool gzip = headers.find("\r\nContent-Encoding: gzip\r\n") != std::string::npos;
+        const char* name = cases[i].accept_encoding ? cases[i].accept_encoding : "(none)";
+        std::cout << "'" << name << "' -> " << (gzip ? "gzip" : "identity") << std::endl;
+        if (gzip != cases[i].gzip)
+        {
+            std::cerr << "  expected " << (cases[i].gzip ? "gzip" : "identity") << std::endl;
+            failed++;
+        }
+    }
+    server.stop();
+    if (failed != 0)return 1;
+
+    std::cout << "\n=== Test completed successfully ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include "npu_history.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/*边界值生成：按概率给出与上一值相同、极值、特殊浮点或随机位模式，覆盖编码的各个分档*/
+class EdgeValues
+{
+public:
+    explicit EdgeValues(unsigned int seed) : rng_(seed) {}
+
+    double next(double prev)
+    {
+        static const double specials[] = {
+            0.0, -0.0, std::numeric_limits<double>::quiet_NaN(), -std::numeric_limits<double>::quiet_NaN(),
+            std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+            DBL_MAX, -DBL_MAX, DBL_MIN, std::numeric_limits<double>::denorm_min(), 1.0, 350.5
+        };
+        switch (rng_() % 6)
+        {
+        case 0: return prev;
+        case 1: return specials[rng_() % (sizeof(specials) / sizeof(specials[0]))];
+        case 2:
+        {
+            //与上一值全部64位都不同
+            uint64_t bits;
+            std::memcpy(&bits, &prev, sizeof(bits));
+            bits = ~bits;
+            double v;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+        case 3:
+        {
+            //任意位模式（含非规格化数与带载荷的NaN）
+            uint64_t bits = ((uint64_t)rng_() << 32) | rng_();
+            double v;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+        default: return prev + (double)(rng_() % 100) / 10.0 - 5.0; //正常波动
+        }
+    }
+
+    template<typename T>
+    T next(T prev)
+    {
+        switch (rng_() % 6)
+        {
+        case 0: return prev;
+        case 1: return std::numeric_limits<T>::max();
+        case 2: return std::numeric_limits<T>::min();
+        case 3: return (T)(((uint64_t)rng_() << 32) | rng_()); //任意跳变
+        default: return (T)(prev + (T)(rng_() % 16) - (T)8); //正常波动（无符号时可能回绕）
+        }
+    }
+
+    /*时间戳：2秒周期加抖动，偶尔重复、回退或长时间中断*/
+    int64_t next_timestamp(int64_t prev)
+    {
+        switch (rng_() % 10)
+        {
+        case 0: return prev;
+        case 1: return prev - (int64_t)(rng_() % 1000);
+        case 2: return prev + (int64_t)(rng_() % 100000000);
+        default: return prev + 2000 + (int64_t)(rng_() % 200) - 100;
+        }
+    }
+
+private:
+    std::mt19937 rng_;
+};
+
+/*两个样本的全部字段是否逐位相同（NaN按位模式比较）*/
+bool same_bits(const NPUMetric& a, const NPUMetric& b)
+{
+#define NPU_METRIC_SAME(field, name, help) \
+    if (std::memcmp(&a.field, &b.field, sizeof(a.field)) != 0)return false;
+    NPU_METRIC_LIST(NPU_METRIC_SAME)
+#undef NPU_METRIC_SAME
+    return true;
+}
+
+/*读取设备(3,5)在[from_ms, to_ms]内的样本*/
+void read_range(NPUHistory& history, int64_t from_ms, int64_t to_ms,
+                std::vector<int64_t>& read_ms, std::vector<NPUMetric>& read)
+{
+    read_ms.clear();
+    read.clear();
+    history.read(3, 5, from_ms, to_ms, [&](int64_t t, const NPUMetric& metric) {
+        read_ms.push_back(t);
+        read.push_back(metric);
+        return true;
+    });
+}
+
+/*写入total个样本，每隔check_every个样本读回全部历史，检查读到的是最近写入的样本且逐位相同*/
+int check_round_trip(unsigned int seed, size_t total, size_t check_every)
+{
+    NPUHistory history(8 * NPU_HISTORY_BLOCK_BYTES);
+    EdgeValues gen(seed);
+    std::vector<NPULabel> labels(1);
+    labels[0].card_id = 3;
+    labels[0].device_id = 5;
+    std::vector<NPUMetric> metrics(1);
+    std::memset(&metrics[0], 0, sizeof(NPUMetric));
+
+    std::vector<int64_t> written_ms;
+    std::vector<NPUMetric> written;
+    int64_t ts = 1700000000000LL;
+    size_t max_kept = 0;
+    for (size_t n = 1; n <= total; n++)
+    {
+        ts = gen.next_timestamp(ts);
+        NPUMetric& m = metrics[0];
+#define NPU_METRIC_NEXT(field, name, help) m.field = gen.next(m.field);
+        NPU_METRIC_LIST(NPU_METRIC_NEXT)
+#undef NPU_METRIC_NEXT
+        history.append(ts, labels, metrics);
+        written_ms.push_back(ts);
+        written.push_back(m);
+        if (n % check_every != 0 && n != total)continue;
+
+        //时间戳可能回退，按全范围读取，读到的应是按写入顺序的一段后缀
+        std::vector<int64_t> read_ms;
+        std::vector<NPUMetric> read;
+        read_range(history, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), read_ms, read);
+        if (read.empty() || read.size() > n)
+        {
+            std::cerr << "seed " << seed << ": read " << read.size() << " of " << n << " samples" << std::endl;
+            return 1;
+        }
+        size_t offset = n - read.size();
+        for (size_t i = 0; i < read.size(); i++)
+        {
+            if (read_ms[i] != written_ms[offset + i] || !same_bits(read[i], written[offset + i]))
+            {
+                std::cerr << "seed " << seed << ": sample " << (offset + i) << " differs after "
+                          << n << " appends" << std::endl;
+                return 1;
+            }
+        }
+        if (read.size() > max_kept)max_kept = read.size();
+    }
+    //环形存储必须已经覆盖过旧块，否则没有测到回绕
+    if (max_kept >= total)
+    {
+        std::cerr << "seed " << seed << ": ring never wrapped" << std::endl;
+        return 1;
+    }
+    std::cout << "seed " << seed << ": " << total << " samples, up to " << max_kept << " kept" << std::endl;
+    return 0;
+}
+
+/*时钟回拨：每step_every个样本把时间戳拨回远超多个块跨度的时间，块内也有小幅回退；
+  全范围读取应返回保留下来的全部样本，有界读取应返回保留样本中落在[from, to]内的全部样本，均按写入顺序*/
+int check_clock_step(unsigned int seed, size_t total, size_t step_every)
+{
+    NPUHistory history(8 * NPU_HISTORY_BLOCK_BYTES);
+    EdgeValues gen(seed);
+    std::mt19937 rng(seed);
+    std::vector<NPULabel> labels(1);
+    labels[0].card_id = 3;
+    labels[0].device_id = 5;
+    std::vector<NPUMetric> metrics(1);
+    std::memset(&metrics[0], 0, sizeof(NPUMetric));
+
+    const int64_t step_back_ms = 10000000; //约2.8小时，一个块只覆盖几分钟
+    std::vector<int64_t> written_ms;
+    std::vector<NPUMetric> written;
+    int64_t ts = 1700000000000LL;
+    size_t steps = 0;
+    for (size_t n = 1; n <= total; n++)
+    {
+        if (n % step_every == 0)
+        {
+            ts -= step_back_ms;
+            steps++;
+        }
+        else if (rng() % 8 == 0)ts -= (int64_t)(rng() % 5000);
+        else ts += 2000;
+        NPUMetric& m = metrics[0];
+#define NPU_METRIC_NEXT(field, name, help) m.field = gen.next(m.field);
+        NPU_METRIC_LIST(NPU_METRIC_NEXT)
+#undef NPU_METRIC_NEXT
+        history.append(ts, labels, metrics);
+        written_ms.push_back(ts);
+        written.push_back(m);
+    }
+
+    std::vector<int64_t> read_ms;
+    std::vector<NPUMetric> read;
+    read_range(history, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), read_ms, read);
+    size_t kept = read.size();
+    //保留的样本里必须跨过至少两次回拨，否则没有测到跨块回拨
+    if (kept < 2 * step_every || kept >= total)
+    {
+        std::cerr << "seed " << seed << ": " << kept << " of " << total << " samples kept after clock steps" << std::endl;
+        return 1;
+    }
+    size_t offset = total - kept;
+    for (size_t i = 0; i < kept; i++)
+    {
+        if (read_ms[i] != written_ms[offset + i] || !same_bits(read[i], written[offset + i]))
+        {
+            std::cerr << "seed " << seed << ": full read differs at sample " << (offset + i) << std::endl;
+            return 1;
+        }
+    }
+
+    //有界读取：窗口起点取自保留样本附近，宽度可跨越多个块和回拨
+    for (int w = 0; w < 64; w++)
+    {
+        int64_t from_ms = written_ms[offset + rng() % kept] - (int64_t)(rng() % 5000);
+        int64_t to_ms = from_ms + (int64_t)(rng() % (3 * step_every * 2000));
+        read_range(history, from_ms, to_ms, read_ms, read);
+        size_t k = 0;
+        for (size_t i = offset; i < total; i++)
+        {
+            if (written_ms[i] < from_ms || written_ms[i] > to_ms)continue;
+            if (k >= read.size() || read_ms[k] != written_ms[i] || !same_bits(read[k], written[i]))
+            {
+                std::cerr << "seed " << seed << ": read of [" << from_ms << ", " << to_ms
+                          << "] differs at sample " << i << std::endl;
+                return 1;
+            }
+            k++;
+        }
+        if (k != read.size())
+        {
+            std::cerr << "seed " << seed << ": read of [" << from_ms << ", " << to_ms << "] returned "
+                      << read.size() << " samples, expected " << k << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "seed " << seed << ": " << steps << " clock steps, " << kept << " kept, bounded reads match" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    std::cout << "=== NPU History Codec Test ===" << std::endl;
+    for (unsigned int seed = 1; seed <= 8; seed++)
+    {
+        if (check_round_trip(seed, 5000, 37) != 0)return 1;
+    }
+
+    std::cout << "\n=== Clock Step Test ===" << std::endl;
+    for (unsigned int seed = 1; seed <= 8; seed++)
+    {
+        if (check_clock_step(seed, 2000, 40) != 0)return 1;
+    }
+    std::cout << "\n=== Test completed successfully ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "npu_history_endpoint.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int64_t BASE_MS = 1700000000000LL;
+
+/*向127.0.0.1:port发送一个GET请求，返回去掉chunked编码后的正文；失败时返回false*/
+bool http_get(int port, const std::string& target, std::string& body)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)return false;
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    std::string req = "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    if (send(fd, req.data(), req.size(), 0) != (ssize_t)req.size())
+    {
+        close(fd);
+        return false;
+    }
+    //服务器处理一个请求后关闭连接，读到EOF为止
+    std::string raw;
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)raw.append(buf, (size_t)n);
+    close(fd);
+
+    size_t pos = raw.find("\r\n\r\n");
+    if (raw.compare(0, 12, "HTTP/1.1 200") != 0 || pos == std::string::npos)return false;
+    pos += 4;
+    body.clear();
+    while (true)
+    {
+        size_t line_end = raw.find("\r\n", pos);
+        if (line_end == std::string::npos)return false;
+        size_t size = std::strtoul(raw.substr(pos, line_end - pos).c_str(), nullptr, 16);
+        if (size == 0)return true;
+        if (line_end + 2 + size > raw.size())return false;
+        body.append(raw, line_end + 2, size);
+        pos = line_end + 2 + size + 2;
+    }
+}
+
+/*查询power并与期望的values数组比较*/
+bool check_values(int port, const std::string& query, const std::string& expected)
+{
+    std::string body;
+    if (!http_get(port, "/history?card=3&device=5&metric=power&from=1700000000&to=1700000010" + query, body))
+    {
+        std::cerr << "Request " << query << " failed" << std::endl;
+        return false;
+    }
+    size_t pos = body.find("\"values\":");
+    if (pos == std::string::npos || body.compare(pos + 9, std::string::npos, expected + "}\n") != 0)
+    {
+        std::cerr << "Unexpected response for '" << query << "': " << body << std::endl;
+        return false;
+    }
+    std::cout << query << " -> " << expected << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    std::cout << "=== NPU History Endpoint Test ===" << std::endl;
+
+    NPUHistory history(8 * NPU_HISTORY_BLOCK_BYTES);
+    std::vector<NPULabel> labels(1);
+    labels[0].card_id = 3;
+    labels[0].device_id = 5;
+    std::vector<NPUMetric> metrics(1);
+    std::memset(&metrics[0], 0, sizeof(NPUMetric));
+    const double powers[] = {
+        350.5, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(), 12.25
+    };
+    for (size_t i = 0; i < sizeof(powers) / sizeof(powers[0]); i++)
+    {
+        metrics[0].power = powers[i];
+        history.append(BASE_MS + (int64_t)i * 2000, labels, metrics);
+    }
+
+    NPUHistoryEndpoint endpoint(history);
+    NPUHttpServer server("127.0.0.1:0", 1);
+    endpoint.serve(server);
+    server.start();
+
+    std::cout << "\n--- Non-finite Values ---" << std::endl;
+    //原始样本：NaN与正负无穷写为null
+    if (!check_values(server.port(), "",
+        "[[1700000000.000,350.5],[1700000002.000,null],[1700000004.000,null],"
+        "[1700000006.000,null],[1700000008.000,12.25]]"))return 1;
+    //4秒一桶求均值：含NaN的桶、inf与-inf相加得到的NaN均写为null
+    if (!check_values(server.port(), "&step=4&agg=avg",
+        "[[1700000000.000,null],[1700000004.000,null],[1700000008.000,12.25]]"))return 1;
+    server.stop();
+
+    std::cout << "\n=== Test completed successfully ===" << std::endl;
+    return 0;
+}
@@ -1,14 +1,18 @@
 #include "npu_impl.h"
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <cstring>
 
-int main()
+int main(int argc, char* argv[])
 {
     std::cout << "=== NPU Implementation Test ===" << std::endl;
     try
     {
-        // 1. 创建NPUImpl 对象
-        NPUImpl npu;
+        // 1. 创建NPUImpl 对象（参数 parallel 选择并行采样）
+        bool parallel = argc > 1 && std::strcmp(argv[1], "parallel") == 0;
+        NPUImpl npu(parallel ? NPUSampleMode::PARALLEL : NPUSampleMode::SERIAL);
+        std::cout << "Sample mode: " << (parallel ? "parallel" : "serial") << std::endl;
         std::cout << "Collector name: " << npu.name() << std::endl;
         
         // 2. 获取设备标签
@@ -27,7 +31,11 @@ int main()
         
         // 3. 采集指标数据
         std::cout << "\nSampling metrics..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
         auto metrics = npu.sample();
+        auto cost = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Sample cycle took " << cost << " us" << std::endl;
         std::cout << "\n=== Metrics for " << metrics.size() << " device(s) ===" << std::endl;
         
         for (size_t i = 0; i < metrics.size(); i++)
@@ -56,6 +64,12 @@ int main()
             std::cout << "    (0: OK, 1: WARN, 2: ERROR, 3: CRITICAL, 0xFFFFFFFF: NOT_EXIST)" << std::endl;
             std::cout << "  Temperature: " << m.temperature << " °C" << std::endl;
             std::cout << "  Voltage:     " << m.voltage << " V" << std::endl;
+            // HBM
+            std::cout << "HBM:" << std::endl;
+            std::cout << "  Used:        " << m.hbm_used / (1024 * 1024) << " / " << m.hbm_total / (1024 * 1024) << " MB" << std::endl;
+            std::cout << "  Temperature: " << m.hbm_temperature << " °C" << std::endl;
+            std::cout << "  Bandwidth:   " << m.util_hbm_bw << "%" << std::endl;
+            std::cout << "  Stale:       " << m.stale << std::endl;
         }
         std::cout << "\n=== Test completed successfully ===" << std::endl;
         
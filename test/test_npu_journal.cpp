@@ -0,0 +1,221 @@
+#include "npu_journal.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const size_t HEADER_BYTES = 4096; //与npu_journal.cpp一致：文件头占一页
+const size_t RECORD_NUM = 100;
+const int DEVICE_NUM = 8;
+const int64_t BASE_MS = 1700000000000LL;
+
+int64_t cycle_ts(int cycle)
+{
+    return BASE_MS + (int64_t)cycle * 2000;
+}
+
+NPUMetric cycle_metric(int cycle, int device)
+{
+    NPUMetric metric;
+    std::memset(&metric, 0, sizeof(metric));
+    metric.util_aicore = (uint32_t)(cycle * 100 + device);
+    metric.aicore_freq = (uint32_t)(1000 + cycle);
+    return metric;
+}
+
+void append_cycle(NPUJournal& journal, int cycle)
+{
+    std::vector<NPULabel> labels;
+    std::vector<NPUMetric> metrics;
+    for (int d = 0; d < DEVICE_NUM; d++)
+    {
+        NPULabel label = {d / 2, d % 2};
+        labels.push_back(label);
+        metrics.push_back(cycle_metric(cycle, d));
+    }
+    journal.append(cycle_ts(cycle), labels, metrics);
+}
+
+//cycle从0开始，每周期DEVICE_NUM条，序号从1开始
+uint64_t record_seq(int cycle, int device)
+{
+    return (uint64_t)cycle * DEVICE_NUM + device + 1;
+}
+
+off_t slot_offset(uint64_t seq)
+{
+    return (off_t)(HEADER_BYTES + (seq % RECORD_NUM) * sizeof(NPUJournalRecord));
+}
+
+struct ReplayedCycle
+{
+    int64_t timestamp_ms;
+    std::vector<NPULabel> labels;
+    std::vector<NPUMetric> metrics;
+};
+
+std::vector<ReplayedCycle> reopen_and_replay(const std::string& path, size_t bytes)
+{
+    std::vector<ReplayedCycle> cycles;
+    NPUJournal journal;
+    if (!journal.open(path, bytes))return cycles;
+    journal.replay([&](int64_t ts, const std::vector<NPULabel>& labels, const std::vector<NPUMetric>& metrics)
+    {
+        ReplayedCycle c;
+        c.timestamp_ms = ts;
+        c.labels = labels;
+        c.metrics = metrics;
+        cycles.push_back(c);
+    });
+    return cycles;
+}
+
+/*校验重放结果：周期按时间顺序、无重复设备，读数与写入一致，missing中的(周期,设备)不出现*/
+bool check_cycles(const std::vector<ReplayedCycle>& cycles, int first_cycle, int first_device, int last_cycle,
+                  const std::vector<std::pair<int, int>>& missing)
+{
+    if ((int)cycles.size() != last_cycle - first_cycle + 1)
+    {
+        std::cerr << "Expected " << last_cycle - first_cycle + 1 << " cycles, replayed " << cycles.size() << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < cycles.size(); i++)
+    {
+        int cycle = first_cycle + (int)i;
+        const ReplayedCycle& c = cycles[i];
+        if (c.timestamp_ms != cycle_ts(cycle))
+        {
+            std::cerr << "Cycle " << cycle << " has timestamp " << c.timestamp_ms << std::endl;
+            return false;
+        }
+        std::vector<int> expected;
+        for (int d = cycle == first_cycle ? first_device : 0; d < DEVICE_NUM; d++)
+        {
+            bool skip = false;
+            for (size_t m = 0; m < missing.size(); m++)
+            {
+                if (missing[m].first == cycle && missing[m].second == d)skip = true;
+            }
+            if (!skip)expected.push_back(d);
+        }
+        if (c.labels.size() != expected.size() || c.metrics.size() != expected.size())
+        {
+            std::cerr << "Cycle " << cycle << " has " << c.labels.size() << " devices, expected " << expected.size() << std::endl;
+            return false;
+        }
+        for (size_t k = 0; k < expected.size(); k++)
+        {
+            int d = expected[k];
+            NPUMetric want = cycle_metric(cycle, d);
+            if (c.labels[k].card_id != d / 2 || c.labels[k].device_id != d % 2 ||
+                std::memcmp(&c.metrics[k], &want, sizeof(want)) != 0)
+            {
+                std::cerr << "Cycle " << cycle << " device " << d << " replayed wrong record" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    std::cout << "=== NPU Journal Test ===" << std::endl;
+
+    std::string path = "/tmp/test_npu_journal_" + std::to_string(getpid()) + ".bin";
+    unlink(path.c_str());
+    size_t bytes = HEADER_BYTES + RECORD_NUM * sizeof(NPUJournalRecord);
+
+    //40个周期共320条记录，环形区绕过3圈多：剩下序号221..320，即周期27的设备4..7与周期28..39
+    const int cycle_num = 40;
+    {
+        NPUJournal journal;
+        if (!journal.open(path, bytes) || journal.capacity() != RECORD_NUM)
+        {
+            std::cerr << "Failed to open journal " << path << std::endl;
+            return 1;
+        }
+        if (journal.replay([](int64_t, const std::vector<NPULabel>&, const std::vector<NPUMetric>&) {}) != 0)
+        {
+            std::cerr << "New journal should be empty" << std::endl;
+            return 1;
+        }
+        for (int c = 0; c < cycle_num; c++)append_cycle(journal, c);
+    }
+
+    std::cout << "\n=== Wrapped Replay Test ===" << std::endl;
+    std::vector<ReplayedCycle> cycles = reopen_and_replay(path, bytes);
+    if (!check_cycles(cycles, 27, 4, cycle_num - 1, std::vector<std::pair<int, int>>()))return 1;
+    std::cout << "Replayed " << cycles.size() << " cycles after wrap" << std::endl;
+
+    std::cout << "\n=== Corrupt Record Test ===" << std::endl;
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0)
+    {
+        std::cerr << "Failed to open journal file for corruption" << std::endl;
+        return 1;
+    }
+    //周期33设备3：翻转读数中的一个字节，crc不再匹配（模拟写到一半崩溃）
+    NPUJournalRecord record;
+    off_t offset = slot_offset(record_seq(33, 3));
+    if (pread(fd, &record, sizeof(record), offset) != (ssize_t)sizeof(record) || record.seq != record_seq(33, 3))
+    {
+        std::cerr << "Unexpected record layout in journal file" << std::endl;
+        close(fd);
+        return 1;
+    }
+    record.metric.util_aicore ^= 0x40;
+    pwrite(fd, &record, sizeof(record), offset);
+    //周期35设备5的槽位写入周期35设备6的完整记录（crc有效但序号与槽位不符，模拟旧圈残留）
+    if (pread(fd, &record, sizeof(record), slot_offset(record_seq(35, 6))) != (ssize_t)sizeof(record))
+    {
+        std::cerr << "Failed to read journal record" << std::endl;
+        close(fd);
+        return 1;
+    }
+    pwrite(fd, &record, sizeof(record), slot_offset(record_seq(35, 5)));
+    close(fd);
+
+    std::vector<std::pair<int, int>> missing;
+    missing.push_back(std::make_pair(33, 3));
+    missing.push_back(std::make_pair(35, 5));
+    cycles = reopen_and_replay(path, bytes);
+    if (!check_cycles(cycles, 27, 4, cycle_num - 1, missing))return 1;
+    std::cout << "Corrupted and stale-lap records dropped, cycles kept whole" << std::endl;
+
+    std::cout << "\n=== Reopen And Append Test ===" << std::endl;
+    //重新打开后从最大有效序号之后继续写，再绕过一个周期
+    {
+        NPUJournal journal;
+        if (!journal.open(path, bytes))
+        {
+            std::cerr << "Failed to reopen journal" << std::endl;
+            return 1;
+        }
+        journal.replay([](int64_t, const std::vector<NPULabel>&, const std::vector<NPUMetric>&) {});
+        append_cycle(journal, cycle_num);
+    }
+    cycles = reopen_and_replay(path, bytes);
+    if (!check_cycles(cycles, 28, 4, cycle_num, missing))return 1;
+    std::cout << "Appended cycle replayed after reopen" << std::endl;
+
+    //文件头与当前大小不符时重新初始化，不重放旧内容
+    cycles = reopen_and_replay(path, bytes + HEADER_BYTES);
+    if (!cycles.empty())
+    {
+        std::cerr << "Resized journal should start empty" << std::endl;
+        return 1;
+    }
+
+    unlink(path.c_str());
+    std::cout << "\n=== Test completed successfully ===" << std::endl;
+    return 0;
+}
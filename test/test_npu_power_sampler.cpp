@@ -0,0 +1,84 @@
+#include "dcmi_sim.h"
+#include "npu_power_sampler.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds(Clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+/*每隔interval采样一次，共n次*/
+void sample_for(NPUPowerSampler& sampler, int n, std::chrono::milliseconds interval)
+{
+    for (int i = 0; i < n; i++)
+    {
+        sampler.sample_once();
+        std::this_thread::sleep_for(interval);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::cout << "=== NPU Power Sampler Test ===" << std::endl;
+    if (dcmi_init() != DCMI_OK)
+    {
+        std::cerr << "Failed to init simulated DCMI" << std::endl;
+        return 1;
+    }
+
+    NPUPowerSampler sampler(100, std::chrono::seconds(10));
+    std::vector<NPULabel> labels(1);
+    labels[0].card_id = 0;
+    labels[0].device_id = 0;
+    sampler.set_devices(labels);
+
+    std::cout << "\n--- Read Failure Outage ---" << std::endl;
+    //读取成功约40ms，随后连续失败约600ms，恢复后再成功约40ms
+    Clock::time_point start = Clock::now();
+    sample_for(sampler, 3, std::chrono::milliseconds(20));
+    Clock::time_point outage_start = Clock::now();
+    dcmi_sim_add_fault(DCMI_SIM_CALL_POWER_INFO, 0, 0, DCMI_ERR_CODE_INNER_ERR, 0);
+    sample_for(sampler, 30, std::chrono::milliseconds(20));
+    dcmi_sim_clear_faults();
+    Clock::time_point outage_end = Clock::now();
+    sample_for(sampler, 3, std::chrono::milliseconds(20));
+    Clock::time_point end = Clock::now();
+
+    sampler.rotate_windows();
+    std::vector<NPUPowerWindow> windows;
+    sampler.windows(windows);
+    if (windows.size() != 1)
+    {
+        std::cerr << "Expected 1 window, got " << windows.size() << std::endl;
+        return 1;
+    }
+    const NPUPowerWindow& w = windows[0];
+    if (w.samples != 6)
+    {
+        std::cerr << "Expected 6 successful readings, got " << w.samples << std::endl;
+        return 1;
+    }
+    //只有两段成功读数之间的时间计入能耗：上界为最大功率乘以两段的时长，跨中断积分会超出
+    double sampled_s = seconds(outage_start - start) + seconds(end - outage_end);
+    double outage_s = seconds(outage_end - outage_start);
+    double limit = w.max_watts * sampled_s;
+    std::cout << "energy " << w.energy_joules << " J over " << sampled_s << " s sampled, "
+              << outage_s << " s outage (limit " << limit << " J)" << std::endl;
+    if (w.energy_joules <= 0.0 || w.energy_joules > limit)
+    {
+        std::cerr << "Energy integrated across the read outage" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Test completed successfully ===" << std::endl;
+    return 0;
+}
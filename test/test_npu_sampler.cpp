@@ -0,0 +1,240 @@
+#include "npu_impl.h"
+#include "npu_sampler.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+/*假设备：每次sample()把全部设备的全部字段写成本次调用的序号（与发布的周期编号一致），
+  快照中只要混入了不同周期的数据就能发现*/
+class StampNPU
+{
+public:
+    explicit StampNPU(size_t device_num) : labels_(device_num), stamp_(0)
+    {
+        for (size_t i = 0; i < device_num; i++)
+        {
+            labels_[i].card_id = (int)(i / 8);
+            labels_[i].device_id = (int)(i % 8);
+        }
+    }
+
+    const std::vector<NPULabel>& labels() { return labels_; }
+
+    void sample(std::vector<NPUMetric>& metrics)
+    {
+        stamp_++;
+        metrics.resize(labels_.size());
+        for (NPUMetric& m : metrics)
+        {
+#define NPU_METRIC_STAMP(field, name, help) m.field = (decltype(m.field))stamp_;
+            NPU_METRIC_LIST(NPU_METRIC_STAMP)
+#undef NPU_METRIC_STAMP
+        }
+    }
+
+private:
+    std::vector<NPULabel> labels_;
+    uint64_t stamp_;
+};
+
+/*快照内所有设备的所有字段是否都来自周期cycle*/
+bool same_cycle(const NPUSnapshot& snap)
+{
+    double values[NPU_METRIC_NUM];
+    for (const NPUMetric& m : snap.metrics)
+    {
+        npu_metric_values(m, values);
+        for (int k = 0; k < NPU_METRIC_NUM; k++)
+        {
+            if (values[k] != (double)snap.cycle)return false;
+        }
+    }
+    return true;
+}
+
+/*写者不停发布（周期间隔0）时，并发读者读到的每个快照、每份列式读数都必须来自同一周期*/
+int check_torn_reads()
+{
+    std::cout << "--- Seqlock consistency ---" << std::endl;
+    const size_t device_num = 256;
+    StampNPU npu(device_num);
+    NPUSampler<StampNPU> sampler(npu, std::chrono::milliseconds(0));
+    sampler.start();
+
+    const int reader_num = 4;
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_num; r++)
+    {
+        readers.emplace_back([&, r] {
+            NPUSnapshot snap;
+            NPUColumns columns;
+            while (!stop)
+            {
+                if (r % 2 == 0)
+                {
+                    if (!sampler.snapshot(snap))continue;
+                    if (snap.metrics.size() != device_num || !same_cycle(snap))errors++;
+                    continue;
+                }
+                //列式读数：同一列各设备的值相同
+                if (!sampler.columns(columns))continue;
+                if (columns.count != device_num)errors++;
+                for (size_t i = 1; i < columns.count; i++)
+                {
+                    if (columns.power[i] != columns.power[0] || columns.hbm_used[i] != columns.hbm_used[0])
+                    {
+                        errors++;
+                        break;
+                    }
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    stop = true;
+    for (auto& t : readers)t.join();
+    sampler.stop();
+
+    std::cout << "Published cycles: " << sampler.cycle() << std::endl;
+    if (errors != 0 || sampler.cycle() < 2)
+    {
+        std::cerr << "Torn snapshots: " << errors << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*节点汇总与逐设备标量计算一致：设备数覆盖向量分块的各种尾部，只有该项字段读取失败的设备不计入该项汇总*/
+int check_node_aggregate()
+{
+    std::cout << "--- Node aggregate ---" << std::endl;
+    std::mt19937 rng(7);
+    std::unique_ptr<NPUColumns> columns(new NPUColumns());
+    std::vector<NPUMetric> metrics(NPU_MAX_DEVICE_NUM);
+    const size_t counts[] = {0, 1, 3, 7, 8, 9, 17, 255, NPU_MAX_DEVICE_NUM};
+    for (size_t count : counts)
+    {
+        for (int round = 0; round < 20; round++)
+        {
+            //round 0：全部字段失败；round 1：全部成功；round 2：只有功耗与AICPU利用率失败；其余随机失败
+            const uint32_t all = (1u << NPU_METRIC_NUM) - 1;
+            for (size_t i = 0; i < count; i++)
+            {
+                NPUMetric& m = metrics[i];
+                m = NPUMetric();
+                if (round == 0)m.failed = all;
+                else if (round == 2)m.failed = NPU_METRIC_BIT(power) | NPU_METRIC_BIT(util_aicpu);
+                else if (round > 2 && rng() % 4 == 0)m.failed = rng() & all;
+                m.power = (m.failed & NPU_METRIC_BIT(power)) ? 0 : (double)(rng() % 4000) / 10.0;
+                m.util_aicore = (m.failed & NPU_METRIC_BIT(util_aicore)) ? 0 : rng() % 101;
+                m.temperature = (m.failed & NPU_METRIC_BIT(temperature)) ? 0 : (int32_t)(rng() % 140) - 40;
+            }
+            npu_columns_fill(*columns, metrics.data(), count);
+            NPUNodeAggregate node;
+            npu_node_aggregate(*columns, node);
+
+            size_t failed = 0, temperature_devices = 0, util_devices = 0;
+            double power = 0;
+            int32_t temperature_max = 0;
+            uint64_t util_sum = 0;
+            uint32_t util_min = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                const NPUMetric& m = metrics[i];
+                if (m.failed != 0)failed++;
+                power += m.power;
+                if (!(m.failed & NPU_METRIC_BIT(temperature)))
+                {
+                    if (temperature_devices == 0 || m.temperature > temperature_max)temperature_max = m.temperature;
+                    temperature_devices++;
+                }
+                if (!(m.failed & NPU_METRIC_BIT(util_aicore)))
+                {
+                    if (util_devices == 0 || m.util_aicore < util_min)util_min = m.util_aicore;
+                    util_sum += m.util_aicore;
+                    util_devices++;
+                }
+            }
+            //其他字段失败的设备仍计入AICore利用率汇总
+            if (round == 2 && (node.util_aicore_devices != count || node.devices_failed != count))
+            {
+                std::cerr << "Power/AICPU failures must not drop AI Core utilization" << std::endl;
+                return 1;
+            }
+            double util_mean = util_devices == 0 ? 0 : (double)util_sum / util_devices;
+            if (node.devices != count || node.devices_failed != failed || std::abs(node.power_sum - power) > 1e-6 ||
+                node.temperature_devices != temperature_devices || node.temperature_max != temperature_max ||
+                node.util_aicore_devices != util_devices || node.util_aicore_min != util_min ||
+                std::abs(node.util_aicore_mean - util_mean) > 1e-9)
+            {
+                std::cerr << "Aggregate mismatch for " << count << " devices (round " << round << ")" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "Aggregates match the scalar reference" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    std::cout << "=== NPU Sampler Test ===" << std::endl;
+    if (check_torn_reads() != 0)return 1;
+    if (check_node_aggregate() != 0)return 1;
+
+    // 1. 启动后台采样（100ms周期）
+    NPUImpl npu(NPUSampleMode::PARALLEL);
+    size_t device_num = npu.labels().size();
+    std::cout << "Found " << device_num << " NPU device(s)" << std::endl;
+    NPUSampler<NPUImpl> sampler(npu, std::chrono::milliseconds(100));
+    sampler.start();
+
+    // 2. 多个读者并发无锁读取快照，检查一致性
+    const int reader_num = 4;
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<unsigned long long> reads(reader_num, 0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_num; r++)
+    {
+        readers.emplace_back([&, r] {
+            NPUSnapshot snap;
+            uint64_t last_cycle = 0;
+            while (!stop)
+            {
+                if (!sampler.snapshot(snap))continue;
+                //周期编号单调不减，且一个快照内标签与指标一一对应
+                if (snap.cycle < last_cycle || snap.labels.size() != snap.metrics.size() ||
+                    snap.labels.size() != device_num)errors++;
+                last_cycle = snap.cycle;
+                reads[r]++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    stop = true;
+    for (auto& t : readers)t.join();
+    sampler.stop();
+
+    // 3. 输出结果
+    unsigned long long total = 0;
+    for (auto n : reads)total += n;
+    std::cout << "Published cycles: " << sampler.cycle() << std::endl;
+    std::cout << "Snapshot reads:   " << total << " by " << reader_num << " reader(s)" << std::endl;
+    if (errors != 0 || sampler.cycle() == 0)
+    {
+        std::cerr << "Inconsistent snapshots: " << errors << std::endl;
+        return 1;
+    }
+    std::cout << "\n=== Test completed successfully ===" << std::endl;
+    return 0;
+}